@@ -5,12 +5,22 @@
 #pragma once
 
 #include <array>
+#include <span>
+#include <utility>
 #include <dsp/fast_math_functions.h>
+#include <dsp/basic_math_functions.h>
 #include <dsp/statistics_functions.h>
 
+#include "ADC/IAudioSource.hpp"
+#include "Core/FramePool.hpp"
+#include "Core/ThreadWorker.hpp"
+#include "Utils/DurationStats.hpp"
 #include "Utils/Logger.hpp"
 #include "Utils/PeriodicTimer.hpp"
+#include "Utils/StreamingStats.hpp"
+#include "Utils/TimeStamp.hpp"
 #include "zephyr/kernel.h"
+#include "zephyr/sys/atomic.h"
 #include "zephyr/drivers/adc.h"
 #include "zephyr/timing/timing.h"
 
@@ -19,106 +29,424 @@ using namespace Utils;
 
 namespace Adc
 {
-    class AdcReader
+    enum class AcquisitionMode
+    {
+        // one timer expiry + one work item + one blocking read per sample
+        PerSample,
+        // one ADC sequence (extra samplings, driver timed) per frame
+        Sequence
+    };
+
+    class AdcReader final : public IAudioSource
     {
     public:
-        using NotifyFrameReady = function<void(int sampleRate_hz, array<float, Constants::SamplingFrameSize>& out)>;
+        struct Statistics
+        {
+            DurationStats sampleInterval_ns; // PerSample mode only
+            DurationStats frameInterval_ns;
+            DurationStats cpuPerFrame_ns;
+        };
 
-        explicit AdcReader(const adc_dt_spec* spec, PeriodicTimer& timer, Logger& logger)
-            : _spec(spec), _timer(timer), logger_(logger)
+        using Channels = span<const adc_dt_spec, Constants::AudioChannelCount>;
+
+        // All channels have to be on the same ADC; they are sampled together in one sequence.
+        explicit AdcReader(const Channels specs, Core::AudioFramePool& pool, PeriodicTimer& timer,
+                           ThreadWorker& worker, Logger& logger)
+            : _specs(specs), _pool(pool), _timer(timer), _worker(worker), logger_(logger)
         {
-            this->_sequence = {
-                .buffer = &this->_sample_buffer,
-                .buffer_size = sizeof(this->_sample_buffer)
-            };
+            this->_frame_work_wrap.self = this;
         }
 
-        int Initialize(const int interval_us)
+        // Sampling interval from Constants, acquisition mode from Kconfig.
+        int Initialize() override
+        {
+            return Initialize(Constants::SamplingInterval_us,
+                              IS_ENABLED(CONFIG_APP_ADC_SEQUENCE_ACQUISITION)
+                                  ? AcquisitionMode::Sequence
+                                  : AcquisitionMode::PerSample);
+        }
+
+        int Initialize(const int interval_us, const AcquisitionMode mode)
         {
             this->sampleInterval_us = interval_us;
             this->sampleRate_hz = (1'000'000 + interval_us / 2) / interval_us;
+            this->_mode = mode;
+
+            k_work_init(&this->_frame_work_wrap.work, &AdcReader::FrameWorkTrampoline);
+
+            for (const auto& spec : this->_specs)
+            {
+                if (spec.dev != this->_specs[0].dev)
+                {
+                    this->logger_.error("Adc channel %u is not on the first channel's ADC.", spec.channel_id);
+                    return -EINVAL;
+                }
+                if (const auto res = adc_channel_setup_dt(&spec); res != 0)
+                {
+                    this->logger_.error("Adc initialization failed with error: %d.", res);
+                    return res;
+                }
+            }
 
-            k_mutex_init(&this->_mutex);
-            const auto res = adc_channel_setup_dt(this->_spec);
-            adc_sequence_init_dt(this->_spec, &this->_sequence);
-            if (res != 0)
+            if (this->_mode == AcquisitionMode::Sequence)
+            {
+                // the driver times the samplings itself and returns once the frame is complete
+                this->_sequence_options = {
+                    .interval_us = static_cast<uint32_t>(interval_us),
+                    .callback = nullptr,
+                    .user_data = nullptr,
+                    .extra_samplings = static_cast<uint16_t>(Constants::SamplingFrameSize - 1)
+                };
+                // Q15 mono: the driver writes raw samples straight into the pooled frame (set per read)
+                this->_sequence = {
+                    .options = &this->_sequence_options,
+                    .buffer = RawBuffer(),
+                    .buffer_size = Constants::SamplingFrameSize * Constants::AudioChannelCount * sizeof(uint16_t)
+                };
+            }
+            else
+            {
+                this->_sequence = {
+                    .buffer = this->_sample_buffer.data(),
+                    .buffer_size = sizeof(this->_sample_buffer)
+                };
+                this->_timer.init([this] { ReadSample(); });
+            }
+            adc_sequence_init_dt(&this->_specs[0], &this->_sequence);
+            if (CONFIG_APP_ADC_OVERSAMPLING > 0)
             {
-                this->logger_.error("Adc initialization failed with error: %d.", res);
-                return res;
+                // averaged in hardware: 2^n conversions per sampling
+                this->_sequence.oversampling = CONFIG_APP_ADC_OVERSAMPLING;
             }
 
-            this->_timer.init([this] { ReadSample(); });
+            // one sequence for all channels; each sampling yields one value per channel,
+            // ordered by ascending channel id
+            for (size_t c = 0; c < this->_specs.size(); ++c)
+            {
+                this->_sequence.channels |= BIT(this->_specs[c].channel_id);
+                this->_slot[c] = 0;
+                for (const auto& other : this->_specs)
+                {
+                    this->_slot[c] += other.channel_id < this->_specs[c].channel_id ? 1 : 0;
+                }
+            }
+            this->_q15_shift = static_cast<int8_t>(15 - this->_specs[0].resolution);
 
             timing_init();
 
-            this->logger_.info("Adc initialized.");
-            return res;
+            this->logger_.info("Adc initialized (%s mode, %u channels).",
+                               this->_mode == AcquisitionMode::Sequence ? "sequence" : "per-sample",
+                               static_cast<unsigned>(Constants::AudioChannelCount));
+            return 0;
         }
 
-        void Start(const NotifyFrameReady& notify)
+        void Start(const NotifyFrameReady& notify, const int prio) override
         {
             this->_notifyFrameReady = notify;
-            this->_timer.start(this->sampleInterval_us);
+            this->_write_buffer = this->_pool.Acquire(this->_write_handle);
+            if (this->_write_buffer == nullptr)
+            {
+                this->logger_.error("No free frame buffer, Adc not started.");
+                return;
+            }
+
             timing_start();
+            this->_timing = timing_counter_get();
+            this->_frame_timing = this->_timing;
+
+            atomic_set(&this->_running, 1);
+            if (this->_mode == AcquisitionMode::Sequence)
+            {
+                this->_worker.Start([this]
+                {
+                    while (atomic_get(&this->_running))
+                    {
+                        ReadSequence();
+                    }
+                }, prio);
+            }
+            else
+            {
+                this->_timer.start(this->sampleInterval_us);
+            }
             this->logger_.info("Adc started.");
         }
 
-        void ReadFrame()
+        // No new frames after the one being acquired; for benchmarks, the app samples until power off.
+        void Stop()
         {
-            arm_mean_f32(this->_frame.data(), this->_frame.size(), &this->offset_);
+            atomic_set(&this->_running, 0);
+            if (this->_mode == AcquisitionMode::PerSample)
+            {
+                this->_timer.stop();
+            }
+        }
 
-            k_mutex_lock(&this->_mutex, K_FOREVER);
-            this->_notifyFrameReady(this->sampleRate_hz, this->_frame);
-            k_mutex_unlock(&this->_mutex);
+        const Statistics& GetStatistics() const
+        {
+            return this->_stats;
+        }
+
+        uint32_t GetOverruns() const override
+        {
+            return static_cast<uint32_t>(atomic_get(&this->_overruns));
         }
 
     private:
+        /*
+         * The producer fills a pooled buffer it holds exclusively. A completed frame is
+         * handed to the consumer work item through _sealed, together with the producer's
+         * reference. The producer never waits: if the consumer has not picked up the previous
+         * frame yet, that frame is dropped in favour of the newer one, and if every buffer is
+         * still referenced downstream the frame just written is dropped. Both count as overrun.
+         */
+        static constexpr atomic_val_t FreshFrame = 0x1000000;
+
+        static atomic_val_t Pack(const Core::FrameHandle& handle)
+        {
+            return FreshFrame | (static_cast<atomic_val_t>(handle.index) << 16) | handle.generation;
+        }
+
+        static Core::FrameHandle Unpack(const atomic_val_t sealed)
+        {
+            return {static_cast<uint16_t>((sealed >> 16) & 0xFF), static_cast<uint16_t>(sealed & 0xFFFF)};
+        }
+
+        void SealFrame()
+        {
+            // the samples were corrected with the previous estimate; fold this frame's mean into the next one
+            for (size_t c = 0; c < this->_dc.size(); ++c)
+            {
+                this->_dc[c].Add(this->_dc_sum[c] / Constants::SamplingFrameSize);
+                this->_dc_offset[c] = static_cast<Constants::AudioSample>(this->_dc[c].Value());
+                this->_dc_sum[c] = 0.0f;
+            }
+
+            Core::FrameHandle next{};
+            auto* buffer = this->_pool.Acquire(next);
+            if (buffer == nullptr)
+            {
+                atomic_inc(&this->_overruns);
+                return;
+            }
+
+            const auto previous = atomic_set(&this->_sealed, Pack(this->_write_handle));
+            if (previous & FreshFrame)
+            {
+                atomic_inc(&this->_overruns);
+                this->_pool.Release(Unpack(previous));
+            }
+            this->_write_handle = next;
+            this->_write_buffer = buffer;
+            k_work_submit(&this->_frame_work_wrap.work);
+        }
+
+        // Runs in the system workqueue; hands the most recently sealed frame to the consumer.
+        void ReadFrame()
+        {
+            const auto sealed = atomic_set(&this->_sealed, 0);
+            if (!(sealed & FreshFrame))
+            {
+                return;
+            }
+
+            const auto frame = Unpack(sealed);
+            this->_notifyFrameReady(this->sampleRate_hz, frame, this->_captured[frame.index]);
+        }
+
         void ReadSample()
         {
-            // auto now = timing_counter_get();
-            // this->logger_.info("sample time: %d", timing_cycles_to_ns(timing_cycles_get(&this->_timing, &now)));
-            // this->_timing = now;
+            auto now = timing_counter_get();
+            this->_stats.sampleInterval_ns.Add(timing_cycles_to_ns(timing_cycles_get(&this->_timing, &now)));
+            this->_timing = now;
+
+            if (this->_sample_count == 0)
+            {
+                this->_captured[this->_write_handle.index] = TimeStamp::Timestamp::Now();
+            }
+
+            // one read covers all channels
+            if (const auto err = adc_read_dt(&this->_specs[0], &this->_sequence); err < 0)
+            {
+                logger_.error("ADC reading failed with error: %d.", err);
+            }
 
-            if (this->_sample_count >= _frame.size())
+            auto& frame = *this->_write_buffer;
+            for (size_t c = 0; c < frame.size(); ++c)
+            {
+                frame[c][this->_sample_count] = RemoveDc(c, Convert(c, this->_sample_buffer[this->_slot[c]]));
+            }
+            ++this->_sample_count;
+
+            auto end = timing_counter_get();
+            this->_frame_cpu_ns += timing_cycles_to_ns(timing_cycles_get(&now, &end));
+
+            if (this->_sample_count >= Constants::SamplingFrameSize)
             {
-                ReadFrame();
                 this->_sample_count = 0;
+                CompleteFrame();
+                SealFrame();
+            }
+        }
+
+        // Runs on the acquisition thread; blocks for one frame period and wakes once per frame.
+        void ReadSequence()
+        {
+            this->_sequence.buffer = RawBuffer();
+            // the driver takes the first sampling right away
+            this->_captured[this->_write_handle.index] = TimeStamp::Timestamp::Now();
+            if (const auto err = adc_read_dt(&this->_specs[0], &this->_sequence); err < 0)
+            {
+                logger_.error("ADC sequence failed with error: %d.", err);
+                k_sleep(K_MSEC(10));
+                return;
+            }
+
+            auto start = timing_counter_get();
+            auto& frame = *this->_write_buffer;
+#if defined(CONFIG_APP_DSP_Q15)
+            if constexpr (DirectToPool)
+            {
+                // no per-sample loop here: two vector passes instead
+                q15_t mean = 0;
+                arm_shift_q15(frame[0].data(), this->_q15_shift, frame[0].data(), frame[0].size());
+                arm_mean_q15(frame[0].data(), frame[0].size(), &mean);
+                this->_dc_sum[0] = static_cast<float>(mean) * Constants::SamplingFrameSize;
+                arm_offset_q15(frame[0].data(), static_cast<q15_t>(-this->_dc_offset[0]), frame[0].data(),
+                               frame[0].size());
             }
+            else
+#endif
+            {
+                // de-interleave into one plane per channel
+                for (size_t c = 0; c < frame.size(); ++c)
+                {
+                    for (size_t i = 0; i < frame[c].size(); ++i)
+                    {
+                        frame[c][i] = RemoveDc(c, Convert(c, this->_raw_frame[i * Constants::AudioChannelCount +
+                                                                   this->_slot[c]]));
+                    }
+                }
+            }
+            auto end = timing_counter_get();
+            this->_frame_cpu_ns += timing_cycles_to_ns(timing_cycles_get(&start, &end));
+
+            CompleteFrame();
+            SealFrame();
+        }
 
-            auto value = static_cast<int>(_sample_buffer);
-            if (adc_read_dt(this->_spec, &this->_sequence) < 0)
+        void CompleteFrame()
+        {
+            auto now = timing_counter_get();
+            this->_stats.frameInterval_ns.Add(timing_cycles_to_ns(timing_cycles_get(&this->_frame_timing, &now)));
+            this->_stats.cpuPerFrame_ns.Add(this->_frame_cpu_ns);
+            this->_frame_timing = now;
+            this->_frame_cpu_ns = 0;
+
+            if (this->_stats.frameInterval_ns.Count() < StatsReportFrames)
             {
-                logger_.error("ADC reading failed with error: %d.", value);
+                return;
             }
 
-            if (adc_raw_to_microvolts_dt(this->_spec, &value) < 0)
+            const auto& s = this->_stats;
+            this->logger_.debug("frame %llu/%llu/%llu us, sample %llu/%llu us, cpu %llu us/frame, overruns %u",
+                                s.frameInterval_ns.Min() / 1000, s.frameInterval_ns.Avg() / 1000,
+                                s.frameInterval_ns.Max() / 1000, s.sampleInterval_ns.Min() / 1000,
+                                s.sampleInterval_ns.Max() / 1000, s.cpuPerFrame_ns.Avg() / 1000, GetOverruns());
+            this->_stats = Statistics();
+        }
+
+        Constants::AudioSample Convert(const size_t channel, const uint16_t raw) const
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            // raw code scaled to Q15, no conversion to volts
+            return static_cast<q15_t>(raw << this->_q15_shift);
+#else
+            auto value = static_cast<int32_t>(raw);
+            if (adc_raw_to_microvolts_dt(&this->_specs[channel], &value) < 0)
             {
                 logger_.error("value in mV not available: %d.", value);
             }
+            return static_cast<float>(value) / 1'000'000.0f;
+#endif
+        }
 
-            k_mutex_lock(&this->_mutex, K_NO_WAIT);
-            this->_frame[this->_sample_count] = value / 1'000'000 - this->offset_;
-            k_mutex_unlock(&this->_mutex);
+        // DC offset tracked across frames (EMA of the frame means), so the kick band is not
+        // disturbed by a correction step at every frame boundary; accumulates the next frame mean
+        Constants::AudioSample RemoveDc(const size_t channel, const Constants::AudioSample value)
+        {
+            this->_dc_sum[channel] += static_cast<float>(value);
+            return static_cast<Constants::AudioSample>(value - this->_dc_offset[channel]);
+        }
 
-            ++this->_sample_count;
+        void* RawBuffer()
+        {
+            if constexpr (DirectToPool)
+            {
+                return this->_write_buffer ? (*this->_write_buffer)[0].data() : nullptr;
+            }
+            return this->_raw_frame.data();
         }
 
-        const adc_dt_spec* _spec;
+        static void FrameWorkTrampoline(k_work* w)
+        {
+            const auto* wrap = CONTAINER_OF(w, WorkWrap, work);
+            auto* self = static_cast<AdcReader*>(wrap->self);
+            if (!self || !self->_notifyFrameReady)
+            {
+                return;
+            }
+            self->ReadFrame();
+        }
+
+        struct WorkWrap
+        {
+            k_work work;
+            void* self{};
+        };
+
+        static constexpr uint32_t StatsReportFrames = 200;
+        static constexpr float DcAlpha = 0.025f; // ~0.5 s time constant at the frame rate
+        // a single Q15 channel needs no conversion and no de-interleaving: the driver fills the pool buffer
+        static constexpr bool DirectToPool = IS_ENABLED(CONFIG_APP_DSP_Q15) && Constants::AudioChannelCount == 1;
+
+        const Channels _specs;
+        Core::AudioFramePool& _pool;
         PeriodicTimer& _timer;
+        ThreadWorker& _worker;
         Logger& logger_;
 
+        AcquisitionMode _mode{AcquisitionMode::PerSample};
         NotifyFrameReady _notifyFrameReady{};
+        WorkWrap _frame_work_wrap{};
         adc_sequence _sequence{};
-        uint16_t _sample_buffer{};
+        array<uint16_t, Constants::AudioChannelCount> _sample_buffer{};
+        array<uint16_t, DirectToPool ? 0 : Constants::SamplingFrameSize * Constants::AudioChannelCount> _raw_frame{};
+        array<uint8_t, Constants::AudioChannelCount> _slot{}; // position of each channel within one sampling
+        int8_t _q15_shift{};
+        array<Utils::Ema, Constants::AudioChannelCount> _dc = []<size_t... I>(index_sequence<I...>)
+        {
+            return array{((void)I, Utils::Ema(DcAlpha))...};
+        }(make_index_sequence<Constants::AudioChannelCount>());
+        array<float, Constants::AudioChannelCount> _dc_sum{};
+        array<Constants::AudioSample, Constants::AudioChannelCount> _dc_offset{};
         size_t _sample_count{};
         adc_sequence_options _sequence_options{};
-        array<float, Constants::SamplingFrameSize> _frame{};
-        k_mutex _mutex{};
         int sampleInterval_us{};
         int sampleRate_hz{};
 
-        bool calibrated{false};
-        float offset_ = 0;
+        static_assert(Constants::AudioFramePoolSize <= 0xFF, "frame index must fit into _sealed");
+        Core::FrameHandle _write_handle{};
+        Core::AudioBuffer* _write_buffer{nullptr};
+        atomic_t _sealed{ATOMIC_INIT(0)};
+        // indexed like the pool; only written while the producer owns the buffer
+        array<TimeStamp::Timestamp, Constants::AudioFramePoolSize> _captured{};
+        atomic_t _overruns{ATOMIC_INIT(0)};
+        atomic_t _running{ATOMIC_INIT(0)};
+
         timing_t _timing{};
+        timing_t _frame_timing{};
+        uint64_t _frame_cpu_ns{};
+        Statistics _stats{};
     };
 }
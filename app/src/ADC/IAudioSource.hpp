@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+
+#include "Core/FramePool.hpp"
+#include "Utils/TimeStamp.hpp"
+
+using namespace Utils;
+
+namespace Adc
+{
+    /**
+     * Producer of pooled audio frames at Constants::SamplingFrameSize samples each.
+     * Implemented by the ADC reader on hardware and by file replay on native_sim.
+     */
+    class IAudioSource
+    {
+    public:
+        virtual ~IAudioSource() = default;
+
+        // The callback takes over the reference to 'frame' and has to release it.
+        // 'captured' is the time the first sample of the frame was taken.
+        using NotifyFrameReady = std::function<void(int sampleRate_hz, const Core::FrameHandle& frame,
+                                                    const Utils::TimeStamp::Timestamp& captured)>;
+
+        virtual int Initialize() = 0;
+        virtual void Start(const NotifyFrameReady& notify, int prio) = 0;
+
+        // Number of frames dropped because the consumer fell behind or no buffer was free.
+        virtual uint32_t GetOverruns() const = 0;
+    };
+}
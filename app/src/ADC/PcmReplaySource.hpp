@@ -0,0 +1,388 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include "ADC/IAudioSource.hpp"
+#include "ADC/ReplayOptions.hpp"
+#include "Core/FramePool.hpp"
+#include "Core/ThreadWorker.hpp"
+#include "SignalProcessing/Resampler.hpp"
+#include "Utils/DurationStats.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/TimeStamp.hpp"
+#include "zephyr/kernel.h"
+
+extern "C" {
+#include <nsi_host_trampolines.h>
+#include <native_rtc.h>
+}
+
+using namespace Utils;
+
+namespace Adc
+{
+    /**
+     * native_sim only: streams a 16 bit PCM file from the host file system into the frame pool.
+     *
+     * Accepts a canonical WAV file (PCM, 16 bit, mono or stereo) or, if the file has no RIFF header,
+     * raw little-endian s16 mono at Constants::SampleRate_hz. A WAV file at another rate is
+     * resampled to Constants::SampleRate_hz, the rate the detectors and bands are designed for. If
+     * the file has as many channels as the ADC, each goes to its own plane; otherwise every plane
+     * gets the downmix.
+     *
+     * Real time: frames are released at the file's sample rate, so the whole chain including the
+     * animations runs as it would on the board.
+     * As fast as possible: every frame is handed over as soon as a buffer is free. The replay thread
+     * runs below the messaging thread, so each publish is consumed before the next frame is read
+     * and no frame is lost; the reported frames/s is the throughput of ADC->zbus->DSP.
+     *
+     * Throughput is measured on the host wall clock, simulated time does not advance while busy;
+     * it includes the resampling of a file that needs it.
+     */
+    class PcmReplaySource final : public IAudioSource
+    {
+    public:
+        PcmReplaySource(const ReplayOptions& options, const bool realtime, Core::AudioFramePool& pool,
+                        ThreadWorker& worker, Logger& logger)
+            : _options(options), _realtime(realtime), _pool(pool), _worker(worker), logger_(logger)
+        {
+        }
+
+        int Initialize() override
+        {
+            this->_path = this->_options.track;
+            this->_fd = nsi_host_open(this->_path, HostReadOnly);
+            if (this->_fd < 0)
+            {
+                this->logger_.error("Cannot open replay file %s.", this->_path);
+                return -ENOENT;
+            }
+
+            if (const auto res = ReadHeader(); res != 0)
+            {
+                this->logger_.error("Unsupported replay file %s: %d.", this->_path, res);
+                nsi_host_close(this->_fd);
+                this->_fd = -1;
+                return res;
+            }
+
+            if (this->sampleRate_hz != Constants::SampleRate_hz)
+            {
+                this->_resampler.emplace(this->sampleRate_hz, Constants::SampleRate_hz);
+            }
+
+            this->logger_.info("Replaying %s (%d Hz%s, %u ch, %s).", this->_path, this->sampleRate_hz,
+                               this->_resampler ? " resampled" : "", static_cast<unsigned>(this->_channels),
+                               this->_realtime ? "real time" : "as fast as possible");
+            return 0;
+        }
+
+        void Start(const NotifyFrameReady& notify, const int prio) override
+        {
+            if (this->_fd < 0)
+            {
+                this->logger_.error("Replay file not open, replay not started.");
+                return;
+            }
+            this->_notifyFrameReady = notify;
+
+            this->_worker.Start([this]
+            {
+                this->_start_ticks = k_uptime_ticks();
+                this->_start_us = native_rtc_gettime_us(RTC_CLOCK_REALTIME);
+                this->_frame_us = this->_start_us;
+
+                while (ReplayFrame())
+                {
+                }
+
+                nsi_host_close(this->_fd);
+                this->_fd = -1;
+                Report("Replay finished");
+                if (this->_finished)
+                {
+                    this->_finished();
+                }
+            }, ReplayThreadPriority(prio));
+        }
+
+        // Called on the replay thread at the end of the file, after the last frame was consumed.
+        void OnFinished(const std::function<void()>& finished)
+        {
+            this->_finished = finished;
+        }
+
+        uint32_t GetOverruns() const override
+        {
+            // the replay waits for buffers instead of dropping frames
+            return 0;
+        }
+
+    private:
+        static constexpr int HostReadOnly = 0; // O_RDONLY on the host
+        static constexpr uint16_t MaxChannels = 2;
+        static constexpr uint32_t StatsReportFrames = 1000;
+
+        // one value per file channel, in s16 units
+        using Sampling = std::array<float, MaxChannels>;
+
+        // Below the caller's priority (and the messaging thread) so published frames are consumed first.
+        int ReplayThreadPriority(const int prio) const
+        {
+            return this->_realtime ? prio : K_LOWEST_APPLICATION_THREAD_PRIO;
+        }
+
+        // Returns false at the end of the file.
+        bool ReplayFrame()
+        {
+            Core::FrameHandle handle{};
+            auto* buffer = this->_pool.Acquire(handle);
+            while (buffer == nullptr)
+            {
+                k_sleep(K_USEC(100));
+                buffer = this->_pool.Acquire(handle);
+            }
+
+            const auto captured = TimeStamp::Timestamp::Now();
+            auto& frame = *buffer;
+            const bool oneToOne = this->_channels == Constants::AudioChannelCount;
+            for (size_t i = 0; i < Constants::SamplingFrameSize; ++i)
+            {
+                Sampling sampling{};
+                if (!NextSampling(sampling))
+                {
+                    // drop a trailing partial frame
+                    this->_pool.Release(handle);
+                    return false;
+                }
+                float mix = 0.0f;
+                for (uint16_t c = 0; c < this->_channels; ++c)
+                {
+                    mix += sampling[c];
+                }
+                mix /= this->_channels;
+
+                for (size_t c = 0; c < frame.size(); ++c)
+                {
+                    frame[c][i] = ToSample(oneToOne ? sampling[c] : mix);
+                }
+            }
+
+            this->_notifyFrameReady(Constants::SampleRate_hz, handle, captured);
+            ++this->_frames;
+
+            const auto now_us = native_rtc_gettime_us(RTC_CLOCK_REALTIME);
+            this->_wallPerFrame_ns.Add((now_us - this->_frame_us) * 1000);
+            this->_frame_us = now_us;
+            if (this->_wallPerFrame_ns.Count() >= StatsReportFrames)
+            {
+                Report("Replay");
+                this->_wallPerFrame_ns.Reset();
+            }
+
+            if (this->_realtime)
+            {
+                const uint64_t due_us = this->_frames * Constants::SamplingFrameSize * 1'000'000ULL /
+                    Constants::SampleRate_hz;
+                k_sleep(K_TIMEOUT_ABS_TICKS(this->_start_ticks + k_us_to_ticks_ceil64(due_us)));
+            }
+            return true;
+        }
+
+        // the file at Constants::SampleRate_hz, through the resampler if it has another rate
+        bool NextSampling(Sampling& sampling)
+        {
+            if (!this->_resampler)
+            {
+                return ReadSampling(sampling);
+            }
+            while (this->_resampler->NeedsInput())
+            {
+                Sampling input{};
+                if (!ReadSampling(input))
+                {
+                    return false;
+                }
+                this->_resampler->Push(input);
+            }
+            sampling = this->_resampler->Pull();
+            return true;
+        }
+
+        // one sampling of the file, read a frame's worth at a time
+        bool ReadSampling(Sampling& sampling)
+        {
+            if (this->_rawPos == this->_rawCount)
+            {
+                const size_t wanted = Constants::SamplingFrameSize * this->_channels * sizeof(int16_t);
+                this->_rawCount = ReadBytes(this->_raw.data(), wanted) / (this->_channels * sizeof(int16_t));
+                this->_rawPos = 0;
+                if (this->_rawCount == 0)
+                {
+                    return false;
+                }
+            }
+            const auto* raw = &this->_raw[this->_rawPos++ * this->_channels];
+            for (uint16_t c = 0; c < this->_channels; ++c)
+            {
+                sampling[c] = raw[c];
+            }
+            return true;
+        }
+
+        static Constants::AudioSample ToSample(const float pcm)
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            // resampling can overshoot full scale
+            return static_cast<Constants::AudioSample>(pcm > 32767.0f ? 32767.0f : pcm < -32768.0f ? -32768.0f : pcm);
+#else
+            return pcm / 32768.0f;
+#endif
+        }
+
+        void Report(const char* what) const
+        {
+            const uint64_t elapsed_us = native_rtc_gettime_us(RTC_CLOCK_REALTIME) - this->_start_us;
+            const uint64_t audio_us = this->_frames * Constants::SamplingFrameSize * 1'000'000ULL /
+                Constants::SampleRate_hz;
+            this->logger_.info("%s: %llu frames, %llu frames/s, wall %llu/%llu/%llu us per frame, %llu.%02llux real time",
+                               what, this->_frames,
+                               elapsed_us ? this->_frames * 1'000'000ULL / elapsed_us : 0,
+                               this->_wallPerFrame_ns.Min() / 1000, this->_wallPerFrame_ns.Avg() / 1000,
+                               this->_wallPerFrame_ns.Max() / 1000,
+                               elapsed_us ? audio_us / elapsed_us : 0,
+                               elapsed_us ? audio_us * 100 / elapsed_us % 100 : 0);
+        }
+
+        // WAV: walks the chunks up to "data". Anything else is taken as raw s16 mono.
+        int ReadHeader()
+        {
+            std::array<uint8_t, 12> riff{};
+            const auto got = ReadBytes(riff.data(), riff.size());
+            if (got < riff.size() || std::memcmp(riff.data(), "RIFF", 4) != 0 ||
+                std::memcmp(&riff[8], "WAVE", 4) != 0)
+            {
+                // raw PCM: the bytes already read are the first samples
+                std::memcpy(this->_pending.data(), riff.data(), got);
+                this->_pending_len = got;
+                this->_channels = 1;
+                this->sampleRate_hz = Constants::SampleRate_hz;
+                return 0;
+            }
+
+            bool haveFormat = false;
+            while (true)
+            {
+                std::array<uint8_t, 8> chunk{};
+                if (ReadBytes(chunk.data(), chunk.size()) != chunk.size())
+                {
+                    return -EINVAL;
+                }
+                const uint32_t size = Le32(&chunk[4]);
+
+                if (std::memcmp(chunk.data(), "data", 4) == 0)
+                {
+                    return haveFormat ? 0 : -EINVAL;
+                }
+
+                if (std::memcmp(chunk.data(), "fmt ", 4) == 0 && size >= 16)
+                {
+                    std::array<uint8_t, 16> fmt{};
+                    ReadBytes(fmt.data(), fmt.size());
+                    const uint16_t format = Le16(&fmt[0]);
+                    this->_channels = Le16(&fmt[2]);
+                    this->sampleRate_hz = static_cast<int>(Le32(&fmt[4]));
+                    const uint16_t bits = Le16(&fmt[14]);
+                    if (format != 1 || bits != 16 || this->_channels == 0 || this->_channels > MaxChannels ||
+                        this->sampleRate_hz <= 0)
+                    {
+                        return -ENOTSUP;
+                    }
+                    haveFormat = true;
+                    Skip(size - fmt.size() + (size & 1));
+                    continue;
+                }
+
+                // chunks are word aligned
+                Skip(size + (size & 1));
+            }
+        }
+
+        size_t ReadBytes(void* dst, const size_t len)
+        {
+            auto* out = static_cast<uint8_t*>(dst);
+            size_t done = 0;
+            if (this->_pending_len > 0)
+            {
+                done = this->_pending_len < len ? this->_pending_len : len;
+                std::memcpy(out, this->_pending.data(), done);
+                std::memmove(this->_pending.data(), &this->_pending[done], this->_pending_len - done);
+                this->_pending_len -= done;
+            }
+            while (done < len)
+            {
+                const auto n = nsi_host_read(this->_fd, out + done, len - done);
+                if (n <= 0)
+                {
+                    break;
+                }
+                done += static_cast<size_t>(n);
+            }
+            return done;
+        }
+
+        // the host trampolines have no lseek
+        void Skip(size_t len)
+        {
+            std::array<uint8_t, 64> scratch{};
+            while (len > 0)
+            {
+                const size_t step = len < scratch.size() ? len : scratch.size();
+                if (ReadBytes(scratch.data(), step) != step)
+                {
+                    return;
+                }
+                len -= step;
+            }
+        }
+
+        static uint16_t Le16(const uint8_t* p)
+        {
+            return static_cast<uint16_t>(p[0] | (p[1] << 8));
+        }
+
+        static uint32_t Le32(const uint8_t* p)
+        {
+            return static_cast<uint32_t>(Le16(p)) | (static_cast<uint32_t>(Le16(p + 2)) << 16);
+        }
+
+        const ReplayOptions& _options;
+        const char* _path{};
+        const bool _realtime;
+        Core::AudioFramePool& _pool;
+        ThreadWorker& _worker;
+        Logger& logger_;
+
+        NotifyFrameReady _notifyFrameReady{};
+        std::function<void()> _finished{};
+        int _fd{-1};
+        uint16_t _channels{1};
+        int sampleRate_hz{};
+
+        std::optional<SignalProcessing::Resampler<MaxChannels>> _resampler{};
+        std::array<int16_t, Constants::SamplingFrameSize * MaxChannels> _raw{};
+        size_t _rawPos{};
+        size_t _rawCount{};
+        std::array<uint8_t, 12> _pending{};
+        size_t _pending_len{};
+
+        int64_t _start_ticks{};
+        uint64_t _start_us{};
+        uint64_t _frame_us{};
+        uint64_t _frames{};
+        DurationStats _wallPerFrame_ns{};
+    };
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace Adc
+{
+    /**
+     * native_sim replay builds: the files of one run, from the zephyr.exe command line
+     * (-track=<wav or raw PCM> -beats=<annotations>, registered in main.cpp) or the Kconfig paths.
+     * The command line is parsed before the kernel boots, the modules read the paths in
+     * Initialize(), so one build replays and scores a whole corpus.
+     */
+    struct ReplayOptions
+    {
+        const char* track = CONFIG_APP_PCM_REPLAY_FILE;
+#if defined(CONFIG_APP_BEAT_EVALUATION)
+        const char* beats = CONFIG_APP_BEAT_EVALUATION_ANNOTATIONS;
+#endif
+    };
+}
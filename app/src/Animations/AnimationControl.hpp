@@ -16,6 +16,8 @@
 #include "Animations/BeatFlash.hpp"
 #include "Visualization/LedControl.hpp"
 #include "Visualization/LedStripController.hpp"
+#include "Utils/PeriodicTimer.hpp"
+#include "Utils/TimeStamp.hpp"
 
 
 namespace Visualization
@@ -67,6 +69,12 @@ namespace Animations
         {
             k_mutex_init(&this->mutex_);
             frame_timer_.init([this] { NextFrame(); });
+            led_work_wrap_.self = this;
+            k_work_init_delayable(&led_work_wrap_.work, &AnimationControl::LedOffTrampoline);
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+            beat_work_wrap_.self = this;
+            k_work_init_delayable(&beat_work_wrap_.work, &AnimationControl::PredictedBeatTrampoline);
+#endif
         }
 
         void Start(const int period_us) const
@@ -74,18 +82,68 @@ namespace Animations
             frame_timer_.start(period_us);
         }
 
-        void ProcessNextBeat()
+        void ProcessNextBeat(const array<bool, Constants::BeatBandCount>& bands)
         {
             if (k_mutex_lock(&this->mutex_, K_MSEC(50)))
             {
                 return;
             }
-            currentAnimation->ProcessNextBeat();
+            for (size_t band = 1; band < bands.size(); ++band)
+            {
+                if (bands[band])
+                {
+                    currentAnimation->ProcessBandBeat(band);
+                }
+            }
+            if (!bands[0])
+            {
+                k_mutex_unlock(&this->mutex_);
+                return;
+            }
+            // while the tempo is locked, the kick animation runs on the predicted beats
+            if (!TempoLocked())
+            {
+                currentAnimation->ProcessNextBeat();
+            }
             k_mutex_unlock(&this->mutex_);
+            // switched off by the system workqueue, the subscriber lane moves on to the next message
             led_.Set(true);
-            k_sleep(K_MSEC(50));
-            led_.Set(false);
+            k_work_reschedule(&led_work_wrap_.work, K_MSEC(BeatLed_ms));
+        }
+
+#if defined(CONFIG_APP_SPECTRUM_EVENTS)
+        void ProcessSpectrum(const array<uint8_t, Constants::SpectrumBandCount>& levels)
+        {
+            // a newer spectrum follows shortly, not worth waiting for the frame renderer
+            if (k_mutex_lock(&this->mutex_, K_NO_WAIT))
+            {
+                return;
+            }
+            currentAnimation->ProcessSpectrum(levels);
+            k_mutex_unlock(&this->mutex_);
         }
+#endif
+
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+        // Locks onto (or releases) the tempo grid; every estimate re-aligns the next predicted beat.
+        void ProcessTempo(const Utils::TimeStamp::Timestamp& nextBeat, const uint64_t period_ns,
+                          const float confidence)
+        {
+            const bool locked = confidence >= LockConfidence && period_ns > 0;
+            const auto key = k_spin_lock(&this->tempo_lock_);
+            this->tempo_locked_ = locked;
+            this->next_beat_ns_ = nextBeat.nSec;
+            this->beat_period_ns_ = period_ns;
+            k_spin_unlock(&this->tempo_lock_, key);
+
+            if (!locked)
+            {
+                k_work_cancel_delayable(&beat_work_wrap_.work);
+                return;
+            }
+            SchedulePredictedBeat();
+        }
+#endif
 
         void IterateAnimation()
         {
@@ -141,6 +199,111 @@ namespace Animations
         }
 
     private:
+        static constexpr int BeatLed_ms = 50;
+
+        struct WorkWrap
+        {
+            k_work_delayable work;
+            void* self{};
+        };
+
+        // Runs in the system workqueue thread.
+        static void LedOffTrampoline(k_work* work)
+        {
+            auto* dwork = CONTAINER_OF(work, k_work_delayable, work);
+            const auto* wrap = CONTAINER_OF(dwork, WorkWrap, work);
+            auto* self = static_cast<AnimationControl*>(wrap->self);
+            if (!self)
+            {
+                return;
+            }
+            self->led_.Set(false);
+        }
+
+        WorkWrap led_work_wrap_{};
+
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+        static constexpr float LockConfidence = 0.3f;
+        // the beat becomes visible with the next frame: fire about half a frame period early
+        static constexpr uint64_t RenderLead_ns = 5'000'000;
+
+        bool TempoLocked()
+        {
+            const auto key = k_spin_lock(&this->tempo_lock_);
+            const bool locked = this->tempo_locked_;
+            k_spin_unlock(&this->tempo_lock_, key);
+            return locked;
+        }
+
+        // Next grid point that is in the future and at least half a period after the last fired beat.
+        void SchedulePredictedBeat()
+        {
+            const uint64_t now = Utils::TimeStamp::Timestamp::Now().nSec;
+            const auto key = k_spin_lock(&this->tempo_lock_);
+            // ProcessTempo may have released the grid since the caller looked
+            const uint64_t period = this->beat_period_ns_;
+            if (!this->tempo_locked_ || period == 0)
+            {
+                k_spin_unlock(&this->tempo_lock_, key);
+                return;
+            }
+            uint64_t target = this->next_beat_ns_ - RenderLead_ns;
+            const uint64_t earliest = max(now, this->last_fired_ns_ + period / 2);
+            if (target < earliest)
+            {
+                target += (earliest - target + period - 1) / period * period;
+            }
+            this->scheduled_ns_ = target;
+            k_spin_unlock(&this->tempo_lock_, key);
+
+            k_work_reschedule(&beat_work_wrap_.work, K_NSEC(target - now));
+        }
+
+        // Runs in the shared system workqueue: never waits for the animation mutex, the next frame
+        // (at most RenderLead_ns away) hands the beat to the animation.
+        void OnPredictedBeat()
+        {
+            const auto key = k_spin_lock(&this->tempo_lock_);
+            if (!this->tempo_locked_)
+            {
+                k_spin_unlock(&this->tempo_lock_, key);
+                return;
+            }
+            this->last_fired_ns_ = this->scheduled_ns_;
+            k_spin_unlock(&this->tempo_lock_, key);
+
+            atomic_set(&this->predicted_beat_, 1);
+            SchedulePredictedBeat();
+        }
+
+        // Runs in the system workqueue thread.
+        static void PredictedBeatTrampoline(k_work* work)
+        {
+            auto* dwork = CONTAINER_OF(work, k_work_delayable, work);
+            const auto* wrap = CONTAINER_OF(dwork, WorkWrap, work);
+            auto* self = static_cast<AnimationControl*>(wrap->self);
+            if (!self)
+            {
+                return;
+            }
+            self->OnPredictedBeat();
+        }
+
+        WorkWrap beat_work_wrap_{};
+        k_spinlock tempo_lock_{};
+        bool tempo_locked_ = false;
+        uint64_t next_beat_ns_ = 0;
+        uint64_t beat_period_ns_ = 0;
+        uint64_t scheduled_ns_ = 0;
+        uint64_t last_fired_ns_ = 0;
+        atomic_t predicted_beat_{ATOMIC_INIT(0)}; // fired, not yet handed to the animation
+#else
+        static bool TempoLocked()
+        {
+            return false;
+        }
+#endif
+
         void NextFrame()
         {
             if (animationState.cycleAnimations && frame_counter % 1000 == 0)
@@ -154,6 +317,12 @@ namespace Animations
             {
                 return;
             }
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+            if (atomic_clear(&this->predicted_beat_))
+            {
+                currentAnimation->ProcessNextBeat();
+            }
+#endif
             currentAnimation->ProcessNextFrame(*led_strip_.GetLeds());
             k_mutex_unlock(&this->mutex_);
 
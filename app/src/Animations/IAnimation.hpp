@@ -16,6 +16,10 @@ namespace Animations
 
     using LedChain = array<led_rgb, Constants::ChainLength>;
     virtual void ProcessNextFrame(LedChain& leds) = 0;
-    virtual void ProcessNextBeat() = 0;
+    virtual void ProcessNextBeat() = 0; // kick (band 0)
+    // beat in a higher band (snare, hi-hat, see SignalProcessing::BeatBands); ignored by default
+    virtual void ProcessBandBeat(size_t band) {}
+    // log-spaced band levels, lowest band first (CONFIG_APP_SPECTRUM_EVENTS); ignored by default
+    virtual void ProcessSpectrum(const array<uint8_t, Constants::SpectrumBandCount>& levels) {}
   };
 }
@@ -8,6 +8,8 @@
 /************************ global constants **************************************/
 //////////////////////////////////////////////////////////////////////////////////
 
+// the APP CPU image of an AMP build has no ADC, strip or button (see main_appcpu.cpp)
+#if !defined(CONFIG_APP_AMP_REMOTE)
 #if !DT_NODE_EXISTS(DT_PATH(zephyr_user)) || \
 !DT_NODE_HAS_PROP(DT_PATH(zephyr_user), io_channels)
 #error "No suitable devicetree overlay specified"
@@ -26,11 +28,52 @@ ADC_DT_SPEC_GET_BY_IDX(node_id, idx),
 #error Unable to determine length of LED strip
 #endif
 #define CTRL_BTN_NODE DT_ALIAS(ctrl_btn)
+#endif
 
 namespace Constants
 {
 
     static constexpr int SamplingInterval_us = 100; //us
-    static constexpr size_t SamplingFrameSize = 512;
+#if defined(CONFIG_APP_DSP_DECIMATION)
+    static constexpr size_t DecimationFactor = 8; // 10 kHz -> 1.25 kHz, the beat band ends at 140 Hz
+    static constexpr size_t AnalysisWindowSize = 128; // samples per FFT at the decimated rate, 9.8 Hz bins
+    static constexpr size_t AnalysisHopSize = 16; // new (decimated) samples between two FFTs
+#else
+    static constexpr size_t DecimationFactor = 1;
+    static constexpr size_t AnalysisWindowSize = 512; // samples per FFT, 19.5 Hz bins
+    static constexpr size_t AnalysisHopSize = 128; // new samples between two FFTs, sets detection latency
+#endif
+    static constexpr size_t SamplingFrameSize = AnalysisHopSize * DecimationFactor; // every ADC frame carries one hop
+#if defined(CONFIG_APP_DSP_DECIMATION)
+    static constexpr size_t BeatBandCount = 2; // kick, snare (see SignalProcessing::BeatBands)
+#else
+    static constexpr size_t BeatBandCount = 3; // kick, snare, hi-hat
+#endif
+    static constexpr size_t SpectrumBandCount = 16; // log-spaced bands in SpectrumEvent
+    static constexpr int SampleRate_hz = 1'000'000 / SamplingInterval_us;
+    static constexpr int AnalysisSampleRate_hz = SampleRate_hz / DecimationFactor;
+#if defined(CONFIG_APP_AUDIO_RING_TOPIC)
+    static constexpr size_t AudioQueueDepth = 4; // frames the ring holds while the DSP catches up
+#else
+    static constexpr size_t AudioQueueDepth = 1; // the zbus channel keeps the latest frame only
+#endif
+    static constexpr size_t AudioFramePoolSize = 3 + AudioQueueDepth; // writing + sealed + queued + being processed
+#if defined(CONFIG_APP_AMP_REMOTE)
+    static constexpr size_t AudioChannelCount = CONFIG_APP_AMP_CHANNELS; // as sampled by the PRO CPU image
+#else
     static constexpr size_t ChainLength = STRIP_NUM_PIXELS;
+    // one ADC channel per zephyr,user io-channels entry, all sampled in one sequence
+    static constexpr size_t AudioChannelCount = DT_PROP_LEN(DT_PATH(zephyr_user), io_channels);
+#endif
+#if defined(CONFIG_APP_AUDIO_PER_CHANNEL_ANALYSIS)
+    static constexpr size_t AnalysedChannelCount = AudioChannelCount; // one detector per channel
+#else
+    static constexpr size_t AnalysedChannelCount = 1; // mono downmix
+#endif
+
+#if defined(CONFIG_APP_DSP_Q15)
+    using AudioSample = int16_t; // Q15, full scale = 1.0
+#else
+    using AudioSample = float; // volts
+#endif
 }
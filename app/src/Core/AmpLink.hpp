@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+
+#include "SpscRing.hpp"
+
+namespace Core
+{
+    /**
+     * Layout of the memory shared by the two sides of an AmpLink: one ring per direction plus a
+     * header the remote side checks before it touches the rings.
+     * Down: host -> remote (audio frames), Up: remote -> host (results).
+     */
+    template <typename Down, typename Up, size_t DownSlots, size_t UpSlots>
+    struct AmpRegion
+    {
+        using DownMessage = Down;
+        using UpMessage = Up;
+
+        static constexpr uint32_t Magic = 0x31504D41; // "AMP1"
+
+        std::atomic<uint32_t> magic{0};
+        uint32_t generation{}; // bumped by every host Attach(), so the remote notices a reset it slept through
+        uint32_t downSize{};
+        uint32_t upSize{};
+        SpscRing<Down, DownSlots> down{};
+        SpscRing<Up, UpSlots> up{};
+    };
+
+    enum class AmpSide : uint8_t { Host, Remote };
+
+    /**
+     * One side of a message link between two cores over an AmpRegion in shared memory (or between
+     * two threads on a host). Messages are copied through the rings; the doorbell only wakes the
+     * peer and carries no payload, so a missed or coalesced doorbell never loses a message as long
+     * as the woken side drains its ring completely.
+     *
+     * The host (re)initialises the region in Attach() and publishes Magic last; the remote calls
+     * Attach() again before every drain and is only attached while it sees Magic with its own
+     * message sizes, which catches images built with different sample formats or frame sizes and a
+     * host that is resetting the region. Generation() tells the remote that the host has reset the
+     * rings since the last check, e.g. after the other core restarted.
+     */
+    template <typename Region, AmpSide Side>
+    class AmpLink
+    {
+    public:
+        using Tx = std::conditional_t<Side == AmpSide::Host, typename Region::DownMessage, typename Region::UpMessage>;
+        using Rx = std::conditional_t<Side == AmpSide::Host, typename Region::UpMessage, typename Region::DownMessage>;
+        using Doorbell = std::function<void()>;
+
+        AmpLink(Region& region, const Doorbell& doorbell) : region_(region), doorbell_(doorbell)
+        {
+        }
+
+        AmpLink(const AmpLink&) = delete;
+        AmpLink& operator=(const AmpLink&) = delete;
+
+        // Host: resets the region, always succeeds. Remote: true while the host has set up the same layout.
+        bool Attach()
+        {
+            bool attached = true;
+            if constexpr (Side == AmpSide::Host)
+            {
+                this->region_.magic.store(0, std::memory_order_release);
+                new(&this->region_.down) decltype(this->region_.down)();
+                new(&this->region_.up) decltype(this->region_.up)();
+                ++this->region_.generation;
+                this->region_.downSize = sizeof(typename Region::DownMessage);
+                this->region_.upSize = sizeof(typename Region::UpMessage);
+                this->region_.magic.store(Region::Magic, std::memory_order_release);
+                this->generation_ = this->region_.generation;
+            }
+            else
+            {
+                attached = this->region_.magic.load(std::memory_order_acquire) == Region::Magic &&
+                    this->region_.downSize == sizeof(typename Region::DownMessage) &&
+                    this->region_.upSize == sizeof(typename Region::UpMessage);
+                if (attached)
+                {
+                    this->generation_ = this->region_.generation;
+                }
+            }
+            this->attached_.store(attached, std::memory_order_relaxed);
+            return attached;
+        }
+
+        bool Attached() const { return this->attached_.load(std::memory_order_relaxed); }
+
+        // the region's generation as of the last successful Attach()
+        uint32_t Generation() const { return this->generation_; }
+
+        // Copies message into the ring and rings the peer's doorbell; false (and counted) if the ring is full.
+        bool Send(const Tx& message)
+        {
+            if (!Attached() || !TxRing().TryPush(message))
+            {
+                ++this->dropped_;
+                return false;
+            }
+            this->doorbell_();
+            return true;
+        }
+
+        // false once the ring is empty
+        bool Receive(Rx& message)
+        {
+            return Attached() && RxRing().TryPop(message);
+        }
+
+        // messages Send() could not deliver
+        uint32_t Dropped() const { return this->dropped_; }
+
+    private:
+        auto& TxRing()
+        {
+            if constexpr (Side == AmpSide::Host)
+            {
+                return this->region_.down;
+            }
+            else
+            {
+                return this->region_.up;
+            }
+        }
+
+        auto& RxRing()
+        {
+            if constexpr (Side == AmpSide::Host)
+            {
+                return this->region_.up;
+            }
+            else
+            {
+                return this->region_.down;
+            }
+        }
+
+        Region& region_;
+        Doorbell doorbell_;
+        // written by the thread calling Attach(), read by the sending one
+        std::atomic<bool> attached_{false};
+        uint32_t generation_ = 0;
+        uint32_t dropped_ = 0;
+    };
+}
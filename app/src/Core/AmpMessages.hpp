@@ -0,0 +1,43 @@
+#pragma once
+
+#include <variant>
+
+#include "AmpLink.hpp"
+#include "EventTypes.hpp"
+#include "FramePool.hpp"
+
+namespace Core
+{
+    /**
+     * Messages between the PRO CPU image (sampling, LEDs) and the APP CPU image (beat detection)
+     * in an AMP build (CONFIG_APP_AMP_OFFLOAD / CONFIG_APP_AMP_REMOTE).
+     */
+    struct AmpFrame
+    {
+        Utils::TimeStamp::Timestamp captured; // time of the first sample, PRO CPU clock
+        uint32_t sequence;
+        int32_t sample_rate_hz;
+        AudioBuffer samples;
+    };
+
+    // PRO -> APP: audio and the button presses that switch the beat engine
+    using AmpDownMessage = std::variant<AmpFrame, EventTypes::ButtonEvent>;
+    // APP -> PRO: everything the analysis publishes
+    using AmpUpMessage = std::variant<EventTypes::BeatEvent, EventTypes::TempoEvent, EventTypes::SpectrumEvent>;
+
+    using AmpSharedRegion = AmpRegion<AmpDownMessage, AmpUpMessage, 4, 8>;
+    using AmpHostLink = AmpLink<AmpSharedRegion, AmpSide::Host>;
+    using AmpRemoteLink = AmpLink<AmpSharedRegion, AmpSide::Remote>;
+
+#if DT_HAS_CHOSEN(zephyr_ipc_shm)
+    static_assert(sizeof(AmpSharedRegion) <= DT_REG_SIZE(DT_CHOSEN(zephyr_ipc_shm)),
+                  "shared memory region too small for the AMP rings");
+
+    // Both images see the region at the same address. The doorbells carry no payload, so the IPM
+    // driver leaves this memory alone.
+    inline AmpSharedRegion& AmpSharedMemory()
+    {
+        return *reinterpret_cast<AmpSharedRegion*>(DT_REG_ADDR(DT_CHOSEN(zephyr_ipc_shm)));
+    }
+#endif
+}
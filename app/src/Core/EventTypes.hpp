@@ -5,6 +5,7 @@
 #include <array>
 #include <string>
 
+#include "FramePool.hpp"
 #include "MessagePublisher.hpp"
 #include "MessageSubscriber.hpp"
 #include "Utils/Button.hpp"
@@ -17,26 +18,49 @@ namespace Core::EventTypes
 {
     struct BaseEvent
     {
-        Timestamp ts;
+        Timestamp ts; // when the event was created, Timestamp::Now()
     };
 
 
+    // ts: capture time of the first sample in the frame
     struct AudioFrame : BaseEvent
     {
-        Timestamp ts;
-        int sample_rate_hz; // number of valid samples in 'samples'
-        array<float, Constants::SamplingFrameSize> samples; // mono PCM, 16-bit
+        int sample_rate_hz;
+        uint32_t sequence; // running frame number
+        Core::FrameHandle frame; // samples live in the AudioFramePool; retain before use, release after
     };
 
+    // only the handle travels over the bus, never the samples
+    static_assert(sizeof(AudioFrame) <= 32, "AudioFrame must stay a small handle message");
+
     struct ButtonEvent : BaseEvent
     {
-        Timestamp ts;
         UtilsButton::ButtonState state;
     };
 
     struct BeatEvent : BaseEvent
     {
-        array<bool, 2> bands; //beats in different frequency bands
+        array<bool, Constants::BeatBandCount> bands; // beats per frequency band, see SignalProcessing::BeatBands
+        Timestamp captured; // capture time of the audio frame the beat was detected in
+        uint32_t sequence; // AudioFrame::sequence of that frame
+        uint8_t channels; // bit c: beat seen on ADC channel c (bit 0 only for the mono downmix)
+    };
+
+    // published by the TempoTracker about every 100 ms once it has a full onset history
+    struct TempoEvent : BaseEvent
+    {
+        float bpm;
+        float confidence; // 0..1
+        Timestamp nextBeat; // predicted capture time of the next beat
+        uint64_t period_ns;
+    };
+
+    // ts: capture time of the analysed frame. Latest value wins: the channel only holds the newest
+    // spectrum, the subscriber skips notifications for one it has already delivered.
+    struct SpectrumEvent : BaseEvent
+    {
+        array<uint8_t, Constants::SpectrumBandCount> levels; // log-spaced, lowest first, see SignalProcessing::LogSpectrum
+        uint32_t sequence;
     };
 
     enum class AnimCmdType : uint8_t { Next, Prev, SetIndex, SetName, Brightness };
@@ -54,7 +78,7 @@ namespace Core::EventTypes
     };
 
     // 2) Define your app’s message set ONCE
-    using AppMessages = TypeList<AudioFrame, BeatEvent, ButtonEvent>;
+    using AppMessages = TypeList<AudioFrame, BeatEvent, ButtonEvent, TempoEvent, SpectrumEvent>;
 
     // 3) PublisherFrom<List> -> MessagePublisher<...>
     template <typename List>
@@ -80,4 +104,39 @@ namespace Core::EventTypes
     // 5) Final “app types” (use these everywhere; no template lists repeated)
     using AppPublisher = PublisherFrom<AppMessages>::type;
     using AppSubscriber = SubscriberFrom<AppMessages>::type;
+
+    // 6) zbus channel ID of a message: its position in AppMessages, MessageSubscriber dispatches on it
+    template <typename MsgT, typename List>
+    struct ChannelIdIn;
+
+    template <typename MsgT, typename... Ts>
+    struct ChannelIdIn<MsgT, TypeList<Ts...>>
+    {
+        static_assert(Detail::index_of<MsgT, Ts...>() < sizeof...(Ts), "MsgT is not an app message");
+        static constexpr uint32_t value = Detail::index_of<MsgT, Ts...>();
+    };
+
+    template <typename MsgT>
+    inline constexpr uint32_t ChannelId = ChannelIdIn<MsgT, AppMessages>::value;
+}
+
+// Handlers per message type in one image, counted over the modules that subscribe to it; raise the
+// count with the module that adds a subscription.
+namespace zbus_cpp
+{
+    // AudioProcessingModule or AmpOffloadModule; BeatEvaluationModule
+    template <>
+    inline constexpr std::size_t MaxHandlers<Core::EventTypes::AudioFrame> = 2;
+    // VisualizationModule or AmpRemoteModule; BeatEvaluationModule
+    template <>
+    inline constexpr std::size_t MaxHandlers<Core::EventTypes::BeatEvent> = 2;
+    // VisualizationModule; AudioProcessingModule (runtime engine selection) or AmpOffloadModule
+    template <>
+    inline constexpr std::size_t MaxHandlers<Core::EventTypes::ButtonEvent> = 2;
+    // VisualizationModule or AmpRemoteModule
+    template <>
+    inline constexpr std::size_t MaxHandlers<Core::EventTypes::TempoEvent> = 1;
+    // VisualizationModule or AmpRemoteModule
+    template <>
+    inline constexpr std::size_t MaxHandlers<Core::EventTypes::SpectrumEvent> = 1;
 }
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+}
+
+namespace Core
+{
+    /**
+     * Small, trivially copyable reference to a pooled buffer.
+     * The generation guards against a handle outliving the buffer it refers to.
+     */
+    struct FrameHandle
+    {
+        uint16_t index{InvalidIndex};
+        uint16_t generation{};
+
+        static constexpr uint16_t InvalidIndex = 0xFFFF;
+
+        bool IsValid() const
+        {
+            return index != InvalidIndex;
+        }
+    };
+
+    /**
+     * Fixed pool of N buffers with per-buffer reference counts.
+     *
+     * Large payloads (audio frames) stay in the pool and only a FrameHandle travels
+     * over zbus. Every holder of a handle owns one reference:
+     *   - Acquire() hands the producer a fresh buffer with one reference,
+     *   - Retain() takes an additional reference (fails once the buffer was recycled),
+     *   - Release() drops a reference; the buffer is reusable when the count hits zero.
+     *
+     * Reference count and generation share one atomic word so Retain() can never
+     * resurrect a buffer that has already been handed out again.
+     */
+    template <typename BufferT, std::size_t N>
+    class FramePool final
+    {
+        static_assert(N > 0 && N < FrameHandle::InvalidIndex, "invalid pool size");
+
+    public:
+        FramePool() = default;
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+
+        BufferT* Acquire(FrameHandle& handle)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                const atomic_val_t state = atomic_get(&state_[i]);
+                if (RefsOf(state) != 0)
+                {
+                    continue;
+                }
+
+                const atomic_val_t next = Pack(static_cast<uint16_t>(GenerationOf(state) + 1), 1);
+                if (atomic_cas(&state_[i], state, next))
+                {
+                    handle = {static_cast<uint16_t>(i), GenerationOf(next)};
+                    return &buffers_[i];
+                }
+            }
+
+            atomic_inc(&exhausted_);
+            handle = FrameHandle{};
+            return nullptr;
+        }
+
+        const BufferT* Retain(const FrameHandle& handle)
+        {
+            if (!handle.IsValid() || handle.index >= N)
+            {
+                return nullptr;
+            }
+
+            atomic_t& slot = state_[handle.index];
+            while (true)
+            {
+                const atomic_val_t state = atomic_get(&slot);
+                if (RefsOf(state) == 0 || GenerationOf(state) != handle.generation)
+                {
+                    atomic_inc(&stale_);
+                    return nullptr;
+                }
+                if (atomic_cas(&slot, state, state + 1))
+                {
+                    return &buffers_[handle.index];
+                }
+            }
+        }
+
+        void Release(const FrameHandle& handle)
+        {
+            if (!handle.IsValid() || handle.index >= N)
+            {
+                return;
+            }
+            (void)atomic_dec(&state_[handle.index]);
+        }
+
+        BufferT& Get(const FrameHandle& handle)
+        {
+            return buffers_[handle.index];
+        }
+
+        // Number of Acquire() calls that found no free buffer.
+        uint32_t Exhausted() const { return static_cast<uint32_t>(atomic_get(&exhausted_)); }
+
+        // Number of Retain() calls on a handle whose buffer was already recycled.
+        uint32_t Stale() const { return static_cast<uint32_t>(atomic_get(&stale_)); }
+
+    private:
+        static constexpr atomic_val_t Pack(const uint16_t generation, const uint16_t refs)
+        {
+            return static_cast<atomic_val_t>((static_cast<uint32_t>(generation) << 16) | refs);
+        }
+
+        static constexpr uint16_t GenerationOf(const atomic_val_t state)
+        {
+            return static_cast<uint16_t>(static_cast<uint32_t>(state) >> 16);
+        }
+
+        static constexpr uint16_t RefsOf(const atomic_val_t state)
+        {
+            return static_cast<uint16_t>(static_cast<uint32_t>(state) & 0xFFFF);
+        }
+
+        std::array<BufferT, N> buffers_{};
+        std::array<atomic_t, N> state_{};
+        atomic_t exhausted_{ATOMIC_INIT(0)};
+        atomic_t stale_{ATOMIC_INIT(0)};
+    };
+
+    // planar: one contiguous hop per channel, so every channel can go straight into the DSP chain
+    using AudioBuffer = std::array<std::array<Constants::AudioSample, Constants::SamplingFrameSize>,
+                                   Constants::AudioChannelCount>;
+    using AudioFramePool = FramePool<AudioBuffer, Constants::AudioFramePoolSize>;
+}
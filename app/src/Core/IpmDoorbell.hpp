@@ -0,0 +1,56 @@
+#pragma once
+
+extern "C" {
+#include <zephyr/device.h>
+#include <zephyr/drivers/ipm.h>
+#include <zephyr/kernel.h>
+}
+
+namespace Core
+{
+    /**
+     * Inter-processor interrupt without payload: Ring() raises the IPM interrupt on the other core,
+     * Wait() blocks until the other core rang. Doorbells arriving while nobody waits coalesce into one,
+     * so the woken side has to drain everything it was signalled for (see AmpLink).
+     */
+    class IpmDoorbell
+    {
+    public:
+        explicit IpmDoorbell(const device* ipm) : ipm_(ipm)
+        {
+            k_sem_init(&this->rung_, 0, 1);
+        }
+
+        int Initialize()
+        {
+            if (!device_is_ready(this->ipm_))
+            {
+                return -ENODEV;
+            }
+            ipm_register_callback(this->ipm_, &IpmDoorbell::OnInterrupt, this);
+            return ipm_set_enabled(this->ipm_, 1);
+        }
+
+        // no payload: the IPM driver never touches its shared buffer
+        void Ring()
+        {
+            (void)ipm_send(this->ipm_, 1, DoorbellId, nullptr, 0);
+        }
+
+        int Wait(const k_timeout_t timeout)
+        {
+            return k_sem_take(&this->rung_, timeout);
+        }
+
+    private:
+        static constexpr uint32_t DoorbellId = 0;
+
+        static void OnInterrupt(const device*, void* context, uint32_t, volatile void*)
+        {
+            k_sem_give(&static_cast<IpmDoorbell*>(context)->rung_);
+        }
+
+        const device* ipm_;
+        k_sem rung_{};
+    };
+}
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <tuple>
 #include <type_traits>
 
+#include "RingChannel.hpp"
+
 extern "C" {
 #include <zephyr/zbus/zbus.h>
 #include <zephyr/kernel.h>
@@ -15,7 +18,17 @@ extern "C" {
 namespace zbus_cpp
 {
     /**
-     * Typed wrapper around a zbus channel pointer.
+     * What a topic does when its subscriber falls behind.
+     *  - LatestWins: zbus channel, a newer message replaces one not yet read (counted as dropped).
+     *  - Queue: RingChannel, bounded FIFO; publishing into a full ring fails (counted as dropped).
+     *  - Block: Publish() waits up to the topic's timeout before it gives up: a zbus channel for
+     *    the channel and the observer queues, a RingChannel for a free slot, so a burst is queued
+     *    in full as long as the subscriber catches up within the timeout.
+     */
+    enum class Delivery : uint8_t { LatestWins, Queue, Block };
+
+    /**
+     * Typed wrapper around a zbus channel pointer, or around a RingChannel for high rate topics.
      * Binding MsgT at compile time makes Publish<MsgT>() type-safe.
      */
     template <typename MsgT>
@@ -25,10 +38,48 @@ namespace zbus_cpp
                       "zbus messages must be trivially copyable");
 
         const zbus_channel* chan{nullptr};
+        IRingChannel<MsgT>* ring{nullptr};
+        uint8_t lane{0}; // MessageSubscriber lane that drains a ring topic
+        Delivery delivery{Delivery::LatestWins};
+        k_timeout_t timeout{K_NO_WAIT}; // Publish() without an explicit timeout
+        bool claimOnRead{false};
 
         constexpr explicit Topic(const zbus_channel* c) : chan(c)
         {
         }
+
+        constexpr explicit Topic(IRingChannel<MsgT>* r) : ring(r), delivery(Delivery::Queue)
+        {
+        }
+
+        // for publishers that may wait, never for the sampling or DSP threads
+        constexpr Topic Blocking(const k_timeout_t publishTimeout) const
+        {
+            auto topic = *this;
+            topic.delivery = Delivery::Block;
+            topic.timeout = publishTimeout;
+            return topic;
+        }
+
+        constexpr Topic OnLane(const uint8_t index) const
+        {
+            auto topic = *this;
+            topic.lane = index;
+            return topic;
+        }
+
+        /**
+         * Subscriber side, zbus channels only: handlers taking const MsgT& read the message in the
+         * channel instead of a copy. The channel stays claimed until the last handler returns, so a
+         * publisher meanwhile waits or fails with -EBUSY: for small messages and short handlers
+         * that do not keep a reference.
+         */
+        constexpr Topic ClaimOnRead() const
+        {
+            auto topic = *this;
+            topic.claimOnRead = topic.ring == nullptr;
+            return topic;
+        }
     };
 
     template <typename... MsgTs>
@@ -47,9 +98,22 @@ namespace zbus_cpp
          *
          * Usage:
          *   publisher.Publish<BeatEvent>(beatEvent);
+         *
+         * Waits as the topic's Delivery says.
          */
         template <typename MsgT>
-        int Publish(const MsgT& msg, const k_timeout_t timeout = K_NO_WAIT) const noexcept
+        int Publish(const MsgT& msg) const noexcept
+        {
+            static_assert(IsConfigured_<MsgT>(),
+                          "MsgT not configured in this MessagePublisher. "
+                          "Pass Topic<MsgT> to the constructor.");
+
+            return Publish(msg, std::get<Topic<MsgT>>(topics_).timeout);
+        }
+
+        // As above with a timeout of the caller's choice.
+        template <typename MsgT>
+        int Publish(const MsgT& msg, const k_timeout_t timeout) const noexcept
         {
             static_assert(IsConfigured_<MsgT>(),
                           "MsgT not configured in this MessagePublisher. "
@@ -59,6 +123,10 @@ namespace zbus_cpp
                           "MsgT must be trivially copyable");
 
             const auto& topic = std::get<Topic<MsgT>>(topics_);
+            if (topic.ring != nullptr)
+            {
+                return topic.ring->Publish(msg, timeout);
+            }
             if (topic.chan == nullptr)
             {
                 return -EINVAL;
@@ -67,6 +135,18 @@ namespace zbus_cpp
             return zbus_chan_pub(topic.chan, &msg, timeout);
         }
 
+        // true if Publish<MsgT>() hands the message's buffer reference to a ring, see RingChannel
+        template <typename MsgT>
+        bool TakesReference() const noexcept
+        {
+            static_assert(IsConfigured_<MsgT>(),
+                          "MsgT not configured in this MessagePublisher. "
+                          "Pass Topic<MsgT> to the constructor.");
+
+            const auto& topic = std::get<Topic<MsgT>>(topics_);
+            return topic.ring != nullptr && topic.ring->TakesReference();
+        }
+
     private:
         template <typename MsgT>
         static constexpr bool IsConfigured_() noexcept
@@ -5,39 +5,103 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <tuple>
 #include <type_traits>
-#include <functional>   // <-- important
 
 #include "ThreadWorker.hpp"
 #include "Utils/Detail.hpp"
+#include "Utils/InplaceFunction.hpp"
 
 extern "C" {
 #include <zephyr/kernel.h>
+#include <zephyr/sys/__assert.h>
 #include <zephyr/zbus/zbus.h>
 }
 
 namespace zbus_cpp
 {
+    /**
+     * Handlers a MessageSubscriber keeps for MsgT, each one Handler of inline storage. Specialise it
+     * next to the message for the number of modules that subscribe to it; Subscribe() beyond it
+     * fails with -ENOMEM.
+     */
+    template <typename MsgT>
+    inline constexpr std::size_t MaxHandlers = 2;
+
+    /**
+     * Runs the handlers of its topics on one or more lanes. A lane is a thread with its own stack
+     * and priority that serves one zbus observer plus the ring topics bound to it
+     * (Topic::OnLane), so a slow handler only delays the topics of its own lane.
+     *
+     * Which zbus channel reaches which lane is decided where the channel lists its observers;
+     * Topic::OnLane has to match for ring topics only. Handlers of different lanes run
+     * concurrently, a module subscribing on two lanes has to share its state accordingly.
+     */
     template <typename... MsgTs>
     class MessageSubscriber final
     {
     public:
         using Observer = zbus_observer;
 
+        static constexpr std::size_t kMaxLanes = 2;
+
+        // per lane since Start(); written by the lane thread, a snapshot when read from another one
+        struct LaneStats
+        {
+            uint32_t dispatched{0};
+            uint32_t maxQueued{0}; // zbus notifications waiting, the one dispatched included; see RingChannel::HighWater
+            uint32_t maxHandler_us{0}; // longest run of all handlers of one message
+        };
+
+        /**
+         * Per topic since Start(). zbus channels are numbered by their publish count
+         * (CONFIG_ZBUS_CHANNEL_PUBLISH_STATS): a gap is a message overwritten before it was read, a
+         * repeated number a notification for a message already dispatched, which is skipped. Ring
+         * topics count what did not fit into the ring.
+         */
+        struct TopicStats
+        {
+            uint32_t delivered{0};
+            uint32_t dropped{0};
+            uint32_t duplicates{0};
+        };
+
+        // lane 0
         constexpr explicit MessageSubscriber(Utils::ThreadWorker& threadWorker,
                                              const Observer* subscriber,
                                              Topic<MsgTs>... topics)
-            : thread_worker_(threadWorker), subscriber_{subscriber}, topics_{topics...}
+            : topics_{topics...}
         {
+            lanes_[0].worker = &threadWorker;
+            lanes_[0].observer = subscriber;
         }
 
         MessageSubscriber(const MessageSubscriber&) = delete;
         MessageSubscriber& operator=(const MessageSubscriber&) = delete;
 
+        // priority of lane 0
         void Initialize(int prio)
         {
-            this->prio = prio;
+            lanes_[0].prio = prio;
+        }
+
+        /**
+         * Add a lane served by its own thread; returns its index for Topic::OnLane, or -ENOMEM.
+         * Only before Start().
+         */
+        int AddLane(Utils::ThreadWorker& threadWorker, const Observer* subscriber, int prio)
+        {
+            if (running || lane_count_ >= kMaxLanes)
+            {
+                return -ENOMEM;
+            }
+            auto& lane = lanes_[lane_count_];
+            lane.worker = &threadWorker;
+            lane.observer = subscriber;
+            lane.prio = prio;
+            return static_cast<int>(lane_count_++);
         }
 
         void Start()
@@ -45,23 +109,53 @@ namespace zbus_cpp
             if (running) return;
             running = true;
 
-            thread_worker_.Start([this]
+            for (std::size_t l = 0; l < lane_count_; ++l)
             {
-                while (true)
+                k_poll_signal_init(&lanes_[l].ring_signal);
+                (attach_ring_<MsgTs>(l), ...);
+                lanes_[l].worker->Start([this, l]
                 {
-                    (void)DispatchOnce(K_FOREVER);
-                }
-            }, prio);
+                    while (true)
+                    {
+                        (void)DispatchOnce(l, K_FOREVER);
+                    }
+                }, lanes_[l].prio);
+            }
+        }
+
+        std::size_t LaneCount() const { return lane_count_; }
+
+        LaneStats Stats(const std::size_t lane) const
+        {
+            return lane < lane_count_ ? lanes_[lane].stats : LaneStats{};
+        }
+
+        template <typename MsgT>
+        TopicStats Stats() const
+        {
+            static_assert(is_configured_<MsgT>(),
+                          "MsgT not configured in this MessageSubscriber");
+            auto stats = std::get<Slot<MsgT>>(slots_).stats;
+            if (const auto* ring = std::get<zbus_cpp::Topic<MsgT>>(topics_).ring)
+            {
+                stats.dropped += ring->Dropped();
+            }
+            return stats;
         }
 
         /**
+         * Add a handler; up to MaxHandlers<MsgT> modules can subscribe to the same message type.
+         * Returns -ENOMEM beyond that, -EINVAL for an empty callable; both assert, as neither can
+         * happen in a configuration that was counted right.
          * Subscribe with any callable:
          *   - lambda:  [](const MsgT& m) { ... }
          *   - functor: struct H { void operator()(const MsgT&) { ... } };
-         *   - std::function<void(const MsgT&)>
+         * The callable is stored inline (Handler), captures beyond a few pointers do not compile.
+         * Handlers taking const MsgT& share the message (read in place on ClaimOnRead topics),
+         * a handler taking MsgT& gets a copy of its own and keeps the topic on the copying path.
          */
         template <typename MsgT, typename F>
-        int Subscribe(F&& f) noexcept
+        [[nodiscard]] int Subscribe(F&& f) noexcept
         {
             static_assert(is_configured_<MsgT>(),
                           "MsgT not configured in this MessageSubscriber");
@@ -71,9 +165,21 @@ namespace zbus_cpp
                           "Handler must be callable as: void(const MsgT&)");
 
             auto& slot = std::get<Slot<MsgT>>(slots_);
-            slot.callback = std::function<void(MsgT&)>(std::forward<F>(f));
-            slot.used = static_cast<bool>(slot.callback);
-            return slot.used ? 0 : -EINVAL;
+            if (slot.used >= MaxHandlers<MsgT>)
+            {
+                __ASSERT(false, "more handlers than zbus_cpp::MaxHandlers of the message type");
+                return -ENOMEM;
+            }
+            auto& callback = slot.callbacks[slot.used];
+            callback = Handler<MsgT>(std::forward<F>(f));
+            if (!callback)
+            {
+                __ASSERT(false, "empty handler");
+                return -EINVAL;
+            }
+            slot.mutating[slot.used] = !std::is_invocable_v<F, const MsgT&>;
+            ++slot.used;
+            return 0;
         }
 
         template <typename MsgT>
@@ -81,19 +187,75 @@ namespace zbus_cpp
         {
             static_assert(is_configured_<MsgT>(),
                           "MsgT not configured in this MessageSubscriber");
-            std::get<Slot<MsgT>>(slots_) = Slot<MsgT>{};
+            // the topic's statistics carry on
+            auto& slot = std::get<Slot<MsgT>>(slots_);
+            slot.callbacks = {};
+            slot.mutating = {};
+            slot.used = 0;
         }
 
-        int DispatchOnce(k_timeout_t timeout = K_FOREVER) noexcept
+        /**
+         * Wait for the next message of a lane and hand it to its handlers. With ring topics on the
+         * lane, waits on the ring signal and the zbus queue together and drains every ring before
+         * returning.
+         */
+        int DispatchOnce(const std::size_t lane, k_timeout_t timeout = K_FOREVER) noexcept
         {
-            if (subscriber_ == nullptr)
+            if (lane >= lane_count_ || lanes_[lane].observer == nullptr)
             {
                 return -EINVAL;
             }
+            auto& l = lanes_[lane];
+            if (!has_rings_(lane))
+            {
+                return dispatch_zbus_(l, timeout);
+            }
+
+            while (true)
+            {
+                // reset before draining: a ring publish after this point raises the signal again
+                k_poll_signal_reset(&l.ring_signal);
+                bool handled = false;
+                (drain_ring_<MsgTs>(l, lane, handled), ...);
+                if (const int rc = dispatch_zbus_(l, K_NO_WAIT); rc == 0 || handled)
+                {
+                    return 0;
+                }
+
+                std::array<k_poll_event, 2> events{};
+                k_poll_event_init(&events[0], K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &l.ring_signal);
+                k_poll_event_init(&events[1], K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+                                  l.observer->queue);
+                if (const int rc = k_poll(events.data(), events.size(), timeout); rc != 0)
+                {
+                    return rc;
+                }
+            }
+        }
+
+        int DispatchOnce(k_timeout_t timeout = K_FOREVER) noexcept
+        {
+            return DispatchOnce(0, timeout);
+        }
+
+    private:
+        static constexpr std::size_t kMaxMsgSize = Detail::max_sizeof<MsgTs...>();
+
+        struct Lane
+        {
+            Utils::ThreadWorker* worker{nullptr};
+            const Observer* observer{nullptr};
+            int prio{0};
+            k_poll_signal ring_signal{};
+            std::array<std::byte, kMaxMsgSize> rx_buf{};
+            LaneStats stats{};
+        };
 
+        int dispatch_zbus_(Lane& lane, k_timeout_t timeout) noexcept
+        {
             const zbus_channel* chan = nullptr;
 
-            const int rc = zbus_sub_wait(subscriber_, &chan, timeout);
+            const int rc = zbus_sub_wait(lane.observer, &chan, timeout);
             if (rc != 0)
             {
                 return rc;
@@ -102,32 +264,77 @@ namespace zbus_cpp
             {
                 return -EIO;
             }
+            const uint32_t queued = k_msgq_num_used_get(lane.observer->queue) + 1;
+            lane.stats.maxQueued = queued > lane.stats.maxQueued ? queued : lane.stats.maxQueued;
 
-            const std::size_t msg_size = zbus_chan_msg_size(chan);
-            if (msg_size > rx_buf_.size())
+            auto match = Match::OtherChannel;
+#if defined(CONFIG_ZBUS_CHANNEL_ID)
+            // channels are defined with their message's position in MsgTs as ID (see EventTypes::ChannelId)
+            using Dispatcher = Match (MessageSubscriber::*)(Lane&, const zbus_channel*) noexcept;
+            static constexpr std::array<Dispatcher, sizeof...(MsgTs)> byId{&MessageSubscriber::try_dispatch_<MsgTs>...};
+            if (chan->id < byId.size())
             {
-                return -ENOBUFS;
+                match = (this->*byId[chan->id])(lane, chan);
             }
-
-            const int read_rc = zbus_chan_read(chan, rx_buf_.data(), K_MSEC(250));
-            if (read_rc != 0)
+#endif
+            if (match == Match::OtherChannel)
+            {
+                // channel with a foreign ID, look it up
+                (((match = try_dispatch_<MsgTs>(lane, chan)) == Match::OtherChannel) && ...);
+            }
+            switch (match)
             {
-                return read_rc;
+            case Match::Handled:
+                return 0;
+            case Match::Duplicate:
+                return -EALREADY;
+            case Match::ReadFailed:
+                return -EIO;
+            default:
+                return -ENOENT;
             }
+        }
 
-            bool handled = false;
-            (try_dispatch_<MsgTs>(chan, msg_size, handled), ...);
-            return handled ? 0 : -ENOENT;
+        // number of the message in the channel, 0 without publish stats; only while claimed
+        static uint32_t published_(const zbus_channel* chan) noexcept
+        {
+#if defined(CONFIG_ZBUS_CHANNEL_PUBLISH_STATS)
+            return zbus_chan_pub_stats_count(chan);
+#else
+            (void)chan;
+            return 0;
+#endif
         }
 
-    private:
+        // copies the message together with its publish count
+        static int read_(const zbus_channel* chan, std::byte* dst, const std::size_t msg_size,
+                         uint32_t& published) noexcept
+        {
+            const int rc = zbus_chan_claim(chan, K_MSEC(250));
+            if (rc != 0)
+            {
+                return rc;
+            }
+            memcpy(dst, zbus_chan_const_msg(chan), msg_size);
+            published = published_(chan);
+            return zbus_chan_finish(chan);
+        }
+
+        template <typename MsgT>
+        using Handler = Utils::InplaceFunction<void(MsgT&)>;
+
         template <typename MsgT>
         struct Slot
         {
-            std::function<void(MsgT&)> callback{};
-            bool used{false};
+            std::array<Handler<MsgT>, MaxHandlers<MsgT>> callbacks{};
+            std::array<bool, MaxHandlers<MsgT>> mutating{}; // takes MsgT&, needs a copy of its own
+            std::size_t used{0};
+            TopicStats stats{};
+            uint32_t lastPublished{0};
         };
 
+        enum class Match : uint8_t { OtherChannel, NoHandler, Duplicate, ReadFailed, Handled };
+
         template <typename MsgT>
         static constexpr bool is_configured_() noexcept
         {
@@ -135,43 +342,146 @@ namespace zbus_cpp
         }
 
         template <typename MsgT>
-        void try_dispatch_(const zbus_channel* chan, std::size_t msg_size, bool& handled) noexcept
+        Match try_dispatch_(Lane& lane, const zbus_channel* chan) noexcept
         {
-            if (handled) return;
-
             const auto& topic = std::get<zbus_cpp::Topic<MsgT>>(topics_);
             if (topic.chan == nullptr || topic.chan != chan)
             {
-                return;
+                return Match::OtherChannel;
+            }
+            if (zbus_chan_msg_size(chan) != sizeof(MsgT))
+            {
+                return Match::NoHandler; // type/channel mismatch guard
             }
 
             auto& slot = std::get<Slot<MsgT>>(slots_);
-            if (!slot.used || !slot.callback)
+            if (topic.claimOnRead && !mutates_(slot))
+            {
+                // zero copy: the handlers read the channel's storage while the lane holds its claim
+                if (zbus_chan_claim(chan, K_MSEC(250)) != 0)
+                {
+                    return Match::ReadFailed;
+                }
+                const auto match = deliver_(lane, slot, published_(chan),
+                                            *static_cast<const MsgT*>(zbus_chan_const_msg(chan)));
+                (void)zbus_chan_finish(chan);
+                return match;
+            }
+
+            uint32_t published = 0;
+            if (read_(chan, lane.rx_buf.data(), sizeof(MsgT), published) != 0)
+            {
+                return Match::ReadFailed;
+            }
+            return deliver_(lane, slot, published, *reinterpret_cast<const MsgT*>(lane.rx_buf.data()));
+        }
+
+        template <typename MsgT>
+        static Match deliver_(Lane& lane, Slot<MsgT>& slot, const uint32_t published, const MsgT& msg) noexcept
+        {
+            if (published != 0)
+            {
+                // latest-wins: several notifications can find the same message in the channel
+                if (published == slot.lastPublished)
+                {
+                    ++slot.stats.duplicates;
+                    return Match::Duplicate;
+                }
+                slot.stats.dropped += published - slot.lastPublished - 1;
+                slot.lastPublished = published;
+            }
+
+            ++slot.stats.delivered;
+            if (slot.used == 0)
+            {
+                return Match::NoHandler;
+            }
+
+            invoke_(lane, slot, msg);
+            return Match::Handled;
+        }
+
+        template <typename MsgT>
+        static bool mutates_(const Slot<MsgT>& slot) noexcept
+        {
+            for (std::size_t i = 0; i < slot.used; ++i)
+            {
+                if (slot.mutating[i])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <typename MsgT>
+        void drain_ring_(Lane& lane, const std::size_t index, bool& handled) noexcept
+        {
+            const auto& topic = std::get<zbus_cpp::Topic<MsgT>>(topics_);
+            if (topic.ring == nullptr || topic.lane != index)
             {
                 return;
             }
 
-            if (msg_size != sizeof(MsgT))
+            // messages without a handler are consumed all the same, as on zbus
+            auto& slot = std::get<Slot<MsgT>>(slots_);
+            MsgT msg;
+            while (topic.ring->TryReceive(msg))
+            {
+                ++slot.stats.delivered;
+                invoke_(lane, slot, msg);
+                topic.ring->Dispatched(msg);
+                handled = true;
+            }
+        }
+
+        template <typename MsgT>
+        static void invoke_(Lane& lane, Slot<MsgT>& slot, const MsgT& msg) noexcept
+        {
+            const uint32_t start = k_cycle_get_32();
+            for (std::size_t i = 0; i < slot.used; ++i)
+            {
+                if (slot.mutating[i])
+                {
+                    // a copy of its own, no handler can alter what the next one sees
+                    auto m = msg;
+                    slot.callbacks[i](m);
+                }
+                else
+                {
+                    // takes const MsgT&: the cast only matches the stored signature, nothing writes
+                    slot.callbacks[i](const_cast<MsgT&>(msg));
+                }
+            }
+            const uint32_t took_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+            auto& stats = lane.stats;
+            ++stats.dispatched;
+            stats.maxHandler_us = took_us > stats.maxHandler_us ? took_us : stats.maxHandler_us;
+        }
+
+        template <typename MsgT>
+        void attach_ring_(const std::size_t index) noexcept
+        {
+            const auto& topic = std::get<zbus_cpp::Topic<MsgT>>(topics_);
+            if (topic.ring != nullptr && topic.lane == index)
             {
-                return; // type/channel mismatch guard
+                topic.ring->Attach(&lanes_[index].ring_signal);
             }
+        }
 
-            auto& m = *reinterpret_cast<MsgT*>(rx_buf_.data());
-            slot.callback(m);
-            handled = true;
+        bool has_rings_(const std::size_t index) const noexcept
+        {
+            return ((std::get<zbus_cpp::Topic<MsgTs>>(topics_).ring != nullptr &&
+                     std::get<zbus_cpp::Topic<MsgTs>>(topics_).lane == index) || ...);
         }
 
-        Utils::ThreadWorker& thread_worker_;
         bool running = false;
-        int prio = 0;
 
-        const Observer* subscriber_{nullptr};
+        std::array<Lane, kMaxLanes> lanes_{};
+        std::size_t lane_count_{1};
 
         std::tuple<zbus_cpp::Topic<MsgTs>...> topics_{};
         std::tuple<Slot<MsgTs>...> slots_{};
-
-        static constexpr std::size_t kMaxMsgSize = Detail::max_sizeof<MsgTs...>();
-        std::array<std::byte, kMaxMsgSize> rx_buf_{};
     };
 }
 
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include "SpscRing.hpp"
+#include "Utils/InplaceFunction.hpp"
+
+extern "C" {
+#include <zephyr/kernel.h>
+}
+
+namespace zbus_cpp
+{
+    /**
+     * Transport of one message type that bypasses zbus, seen through Topic<MsgT>. Publishing
+     * never takes a lock and only waits when given a timeout; the subscriber is woken through the
+     * poll signal it attached in MessageSubscriber::Start().
+     */
+    template <typename MsgT>
+    class IRingChannel
+    {
+    public:
+        // 0, or -ENOBUFS if the consumer is still Capacity messages behind after timeout (the
+        // message is dropped); not from an ISR unless timeout is K_NO_WAIT
+        virtual int Publish(const MsgT& msg, k_timeout_t timeout) = 0;
+        // consumer only; false once empty
+        virtual bool TryReceive(MsgT& msg) = 0;
+        virtual void Attach(k_poll_signal* wake) = 0;
+        // consumer only, after the handlers of a received message returned
+        virtual void Dispatched(const MsgT& msg) = 0;
+        // true if Publish() takes over the reference the message holds, delivered or not
+        virtual bool TakesReference() const = 0;
+        // messages Publish() could not deliver
+        virtual uint32_t Dropped() const = 0;
+
+    protected:
+        virtual ~IRingChannel() = default;
+    };
+
+    /**
+     * Lock-free single producer / single consumer channel, the Queue delivery of zbus_cpp: for high
+     * rate topics (AudioFrame) and for events a burst must not collapse into the latest one.
+     * Unlike a zbus channel it queues instead of keeping only the latest value, delivers with one
+     * copy in and one copy out and does not serialise against other readers.
+     *
+     * Exactly one thread may publish and one MessageSubscriber may receive; the subscriber
+     * dispatches to all its handlers of MsgT as usual. Ordering relative to messages of other
+     * topics (zbus or ring) is not preserved.
+     *
+     * For messages that refer to a pooled buffer (AudioFrame), construct it with the release of
+     * that reference: the ring then owns one reference per queued message. Publish() takes the
+     * publisher's reference over and releases it right away if the ring is full; otherwise it is
+     * released once the subscriber's handlers have run, so a queued buffer cannot be recycled.
+     */
+    template <typename MsgT, size_t Capacity>
+    class RingChannel final : public IRingChannel<MsgT>
+    {
+    public:
+        using Release = Utils::InplaceFunction<void(const MsgT&)>;
+
+        RingChannel() = default;
+
+        explicit RingChannel(const Release& release) : release_(release)
+        {
+        }
+
+        int Publish(const MsgT& msg, const k_timeout_t timeout) override
+        {
+            // the consumer does not signal freed slots, a waiting publisher polls every tick
+            const k_timepoint_t deadline = sys_timepoint_calc(timeout);
+            while (!this->ring_.TryPush(msg))
+            {
+                if (sys_timepoint_expired(deadline))
+                {
+                    this->dropped_.fetch_add(1, std::memory_order_relaxed);
+                    Dispatched(msg);
+                    return -ENOBUFS;
+                }
+                k_sleep(K_TICKS(1));
+            }
+            this->published_.fetch_add(1, std::memory_order_relaxed);
+
+            // only the producer writes the high-water mark
+            const auto depth = static_cast<uint32_t>(this->ring_.Size());
+            if (depth > this->highWater_.load(std::memory_order_relaxed))
+            {
+                this->highWater_.store(depth, std::memory_order_relaxed);
+            }
+
+            if (auto* wake = this->wake_.load(std::memory_order_acquire))
+            {
+                k_poll_signal_raise(wake, 0);
+            }
+            return 0;
+        }
+
+        bool TryReceive(MsgT& msg) override
+        {
+            return this->ring_.TryPop(msg);
+        }
+
+        void Attach(k_poll_signal* wake) override
+        {
+            this->wake_.store(wake, std::memory_order_release);
+        }
+
+        void Dispatched(const MsgT& msg) override
+        {
+            if (this->release_)
+            {
+                this->release_(msg);
+            }
+        }
+
+        bool TakesReference() const override { return static_cast<bool>(this->release_); }
+
+        uint32_t Published() const { return this->published_.load(std::memory_order_relaxed); }
+        uint32_t Dropped() const override { return this->dropped_.load(std::memory_order_relaxed); }
+        // deepest backlog seen by the producer, Capacity means the consumer could not keep up
+        uint32_t HighWater() const { return this->highWater_.load(std::memory_order_relaxed); }
+
+    private:
+        Release release_{};
+        Core::SpscRing<MsgT, Capacity> ring_{};
+        std::atomic<k_poll_signal*> wake_{nullptr};
+        std::atomic<uint32_t> published_{0};
+        std::atomic<uint32_t> dropped_{0};
+        std::atomic<uint32_t> highWater_{0};
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Core
+{
+    /**
+     * Lock-free single producer / single consumer ring of trivially copyable messages, for two
+     * threads or two cores sharing memory. Plain C++, no kernel objects: waking the consumer is up
+     * to the caller (see AmpLink).
+     *
+     * Head and tail are free running; only the producer writes head_, only the consumer tail_.
+     * The release store of head_ publishes the slot contents, the release store of tail_ hands the
+     * slot back. Zero-initialised memory is an empty ring.
+     */
+    template <typename T, size_t Capacity>
+    class SpscRing
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "ring messages are copied as bytes");
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+        static_assert(std::atomic<uint32_t>::is_always_lock_free, "the ring needs lock-free 32 bit atomics");
+
+    public:
+        // producer only; false if the ring is full
+        bool TryPush(const T& message)
+        {
+            const uint32_t head = this->head_.load(std::memory_order_relaxed);
+            if (head - this->tail_.load(std::memory_order_acquire) == Capacity)
+            {
+                return false;
+            }
+            this->slots_[head % Capacity] = message;
+            this->head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consumer only; false if the ring is empty
+        bool TryPop(T& message)
+        {
+            const uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+            if (tail == this->head_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            message = this->slots_[tail % Capacity];
+            this->tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // exact on either side for its own index, a snapshot otherwise
+        size_t Size() const
+        {
+            return this->head_.load(std::memory_order_acquire) - this->tail_.load(std::memory_order_acquire);
+        }
+
+    private:
+        // keeps the indices of producer and consumer apart on cached memory
+        static constexpr size_t CacheLine = 64;
+
+        alignas(CacheLine) std::atomic<uint32_t> head_{0};
+        alignas(CacheLine) std::atomic<uint32_t> tail_{0};
+        alignas(CacheLine) std::array<T, Capacity> slots_{};
+    };
+}
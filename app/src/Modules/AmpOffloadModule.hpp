@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Core/AmpMessages.hpp"
+#include "Core/EventTypes.hpp"
+#include "Core/IpmDoorbell.hpp"
+#include "Core/ThreadWorker.hpp"
+#include "Modules/ModuleBase.hpp"
+#include "Utils/LatencyTracer.hpp"
+#include "Utils/Logger.hpp"
+
+namespace Modules
+{
+    /**
+     * PRO CPU side of an AMP build (CONFIG_APP_AMP_OFFLOAD), in place of the AudioProcessingModule:
+     * hands every audio frame (and button press) to the APP CPU through the shared ring and
+     * republishes the beat, tempo and spectrum events coming back, so the rest of the app does not
+     * notice where the analysis runs.
+     */
+    class AmpOffloadModule final
+    {
+    public:
+        AmpOffloadModule(AppPublisher& publisher, AppSubscriber& subscriber, Core::AudioFramePool& pool,
+                         Core::AmpHostLink& link, Core::IpmDoorbell& doorbell, Utils::ThreadWorker& resultWorker,
+                         Utils::LatencyTracer& latency, Utils::Logger& logger)
+            : logger_(logger), pool_(pool), link_(link), doorbell_(doorbell), result_worker_(resultWorker),
+              latency_(latency), publisher_(publisher), subscriber_(subscriber)
+        {
+        }
+
+        void Initialize()
+        {
+            if (const auto ret = this->doorbell_.Initialize())
+            {
+                this->logger_.error("IPM doorbell could not be initialized: %d.", ret);
+                return;
+            }
+            this->link_.Attach();
+            this->logger_.info("AMP link initialized.");
+        }
+
+        void Start()
+        {
+            int failed = 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::AudioFrame>([&](const Core::EventTypes::AudioFrame& event)
+            {
+                Forward(event);
+            }) != 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::ButtonEvent>([&](const Core::EventTypes::ButtonEvent& event)
+            {
+                this->down_ = event;
+                (void)this->link_.Send(this->down_);
+            }) != 0;
+            if (failed != 0)
+            {
+                this->logger_.error("%d subscription(s) failed.", failed);
+            }
+            this->result_worker_.Start([this]
+            {
+                while (true)
+                {
+                    (void)this->doorbell_.Wait(K_FOREVER);
+                    Drain();
+                }
+            }, ResultThreadPriority);
+            this->logger_.info("AMP offload module started.");
+        }
+
+    private:
+        void Forward(const Core::EventTypes::AudioFrame& event)
+        {
+            const auto* samples = this->pool_.Retain(event.frame);
+            if (samples == nullptr)
+            {
+                return;
+            }
+            const auto forwarded = Timestamp::Now();
+            this->latency_.Record(LatencyStage::Acquisition, forwarded.nSec - event.ts.nSec);
+
+            // the frame is copied into the ring slot; the pooled buffer is free again right after
+            auto& frame = this->down_.emplace<Core::AmpFrame>();
+            frame.captured = event.ts;
+            frame.sequence = event.sequence;
+            frame.sample_rate_hz = event.sample_rate_hz;
+            frame.samples = *samples;
+            this->pool_.Release(event.frame);
+
+            (void)this->link_.Send(this->down_);
+            if (++this->frames_ >= ReportFrames)
+            {
+                this->frames_ = 0;
+                if (this->link_.Dropped() != this->reported_drops_)
+                {
+                    this->logger_.error("APP CPU falling behind: %u messages dropped.", this->link_.Dropped());
+                    this->reported_drops_ = this->link_.Dropped();
+                }
+            }
+        }
+
+        // Republishes everything the APP CPU sent, stamped with this core's clock.
+        void Drain()
+        {
+            while (this->link_.Receive(this->up_))
+            {
+                const auto now = Timestamp::Now();
+                if (auto* beat = std::get_if<Core::EventTypes::BeatEvent>(&this->up_))
+                {
+                    beat->ts = now;
+                    // from the capture of the frame the beat came from: acquisition and the round trip
+                    // to the APP CPU included, both ends on this core's clock
+                    this->latency_.Record(LatencyStage::Detection, now.nSec - beat->captured.nSec);
+                    Publish(*beat);
+                }
+                else if (auto* tempo = std::get_if<Core::EventTypes::TempoEvent>(&this->up_))
+                {
+                    tempo->ts = now;
+                    Publish(*tempo);
+                }
+                else if (auto* spectrum = std::get_if<Core::EventTypes::SpectrumEvent>(&this->up_))
+                {
+                    // latest value wins, a failed publish is replaced by the next spectrum
+                    (void)publisher_.Publish(*spectrum);
+                }
+            }
+        }
+
+        template <typename EventT>
+        void Publish(const EventT& event)
+        {
+            if (const auto err = publisher_.Publish(event))
+            {
+                this->logger_.error("Error republishing APP CPU event: %d", err);
+            }
+        }
+
+        static constexpr int ResultThreadPriority = 1;
+        static constexpr uint32_t ReportFrames = 500;
+
+        Utils::Logger& logger_;
+        Core::AudioFramePool& pool_;
+        Core::AmpHostLink& link_;
+        Core::IpmDoorbell& doorbell_;
+        Utils::ThreadWorker& result_worker_;
+        Utils::LatencyTracer& latency_;
+        AppPublisher& publisher_;
+        AppSubscriber& subscriber_;
+
+        Core::AmpDownMessage down_{}; // staging for Send, messaging thread only
+        Core::AmpUpMessage up_{}; // result thread only
+        uint32_t frames_ = 0;
+        uint32_t reported_drops_ = 0;
+    };
+}
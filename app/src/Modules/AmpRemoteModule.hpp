@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Core/AmpMessages.hpp"
+#include "Core/EventTypes.hpp"
+#include "Core/IpmDoorbell.hpp"
+#include "Core/ThreadWorker.hpp"
+#include "Modules/ModuleBase.hpp"
+#include "Utils/Logger.hpp"
+
+namespace Modules
+{
+    /**
+     * APP CPU side of an AMP build (CONFIG_APP_AMP_REMOTE), in place of the AudioSamplingModule:
+     * publishes the frames arriving from the PRO CPU on this image's bus, where the unchanged
+     * AudioProcessingModule analyses them, and sends its beat, tempo and spectrum events back.
+     * Both directions stage their messages in members, never on the stack: an AmpFrame holds a
+     * whole AudioBuffer, and the frame thread's stack is kept small.
+     */
+    class AmpRemoteModule final
+    {
+    public:
+        AmpRemoteModule(AppPublisher& publisher, AppSubscriber& subscriber, Core::AudioFramePool& pool,
+                        Core::AmpRemoteLink& link, Core::IpmDoorbell& doorbell, Utils::ThreadWorker& frameWorker,
+                        Utils::Logger& logger)
+            : logger_(logger), pool_(pool), link_(link), doorbell_(doorbell), frame_worker_(frameWorker),
+              publisher_(publisher), subscriber_(subscriber)
+        {
+        }
+
+        void Initialize()
+        {
+            if (const auto ret = this->doorbell_.Initialize())
+            {
+                this->logger_.error("IPM doorbell could not be initialized: %d.", ret);
+            }
+        }
+
+        void Start()
+        {
+            int failed = 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::BeatEvent>([&](const Core::EventTypes::BeatEvent& event)
+            {
+                Return(event);
+            }) != 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::TempoEvent>([&](const Core::EventTypes::TempoEvent& event)
+            {
+                Return(event);
+            }) != 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::SpectrumEvent>([&](const Core::EventTypes::SpectrumEvent& event)
+            {
+                Return(event);
+            }) != 0;
+            if (failed != 0)
+            {
+                this->logger_.error("%d subscription(s) failed.", failed);
+            }
+            this->frame_worker_.Start([this]
+            {
+                while (true)
+                {
+                    (void)this->doorbell_.Wait(K_FOREVER);
+                    // re-checked on every doorbell: the PRO CPU resets the rings whenever it restarts
+                    if (!this->link_.Attach())
+                    {
+                        continue;
+                    }
+                    if (this->link_.Generation() != this->generation_)
+                    {
+                        this->generation_ = this->link_.Generation();
+                        this->logger_.info("attached to the PRO CPU (link generation %u).", this->generation_);
+                    }
+                    Drain();
+                }
+            }, FrameThreadPriority);
+            this->logger_.info("AMP remote module started.");
+        }
+
+    private:
+        void Drain()
+        {
+            while (this->link_.Receive(this->down_))
+            {
+                if (const auto* frame = std::get_if<Core::AmpFrame>(&this->down_))
+                {
+                    PublishFrame(*frame);
+                }
+                else if (const auto* button = std::get_if<Core::EventTypes::ButtonEvent>(&this->down_))
+                {
+                    (void)publisher_.Publish(*button);
+                }
+            }
+        }
+
+        // same hand-over as the AudioSamplingModule: the channel holds the reference to the newest frame
+        void PublishFrame(const Core::AmpFrame& frame)
+        {
+            Core::FrameHandle handle{};
+            auto* buffer = this->pool_.Acquire(handle);
+            if (buffer == nullptr)
+            {
+                return;
+            }
+            *buffer = frame.samples;
+
+            auto audioFrame = Core::EventTypes::AudioFrame();
+            audioFrame.ts = frame.captured;
+            audioFrame.sample_rate_hz = frame.sample_rate_hz;
+            audioFrame.sequence = frame.sequence;
+            audioFrame.frame = handle;
+            if (const auto err = publisher_.Publish(audioFrame))
+            {
+                this->logger_.error("failed to publish audio frame: %d", err);
+                this->pool_.Release(handle);
+                return;
+            }
+            this->pool_.Release(this->published_);
+            this->published_ = handle;
+        }
+
+        template <typename EventT>
+        void Return(const EventT& event)
+        {
+            this->up_ = event;
+            (void)this->link_.Send(this->up_);
+        }
+
+        static constexpr int FrameThreadPriority = 0;
+
+        Utils::Logger& logger_;
+        Core::AudioFramePool& pool_;
+        Core::AmpRemoteLink& link_;
+        Core::IpmDoorbell& doorbell_;
+        Utils::ThreadWorker& frame_worker_;
+        AppPublisher& publisher_;
+        AppSubscriber& subscriber_;
+
+        Core::AmpDownMessage down_{}; // frame thread only
+        Core::AmpUpMessage up_{}; // messaging thread only
+        Core::FrameHandle published_{};
+        uint32_t generation_ = 0; // frame thread only
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <utility>
+
+#include "Modules/AudioProcessingModule.hpp"
+#include "SignalProcessing/BeatDetector.hpp"
+#include "SignalProcessing/FftProcessor.hpp"
+#include "SignalProcessing/SpectralFluxDetector.hpp"
+
+namespace Modules
+{
+    /**
+     * Filter and detector state per analysed channel and engine (CONFIG_APP_BEAT_ENGINE_*) for the
+     * AudioProcessingModule; the FFT keeps no state between frames and is shared. Wired up by
+     * whichever image runs the analysis: the single-core app or the APP CPU image of an AMP build.
+     * The detectors refer to members of this object, so it can be neither copied nor moved.
+     */
+    class AnalysisChain final
+    {
+    public:
+        AnalysisChain() = default;
+        AnalysisChain(const AnalysisChain&) = delete;
+        AnalysisChain& operator=(const AnalysisChain&) = delete;
+
+        AudioProcessingModule::Processors Processors()
+        {
+            return [this]<size_t... I>(std::index_sequence<I...>)
+            {
+#if defined(CONFIG_APP_BEAT_ENGINE_RUNTIME)
+                return AudioProcessingModule::Processors{{{&this->beatDetectors_[I], &this->fluxDetectors_[I]}...}};
+#elif defined(CONFIG_APP_BEAT_ENGINE_SPECTRAL_FLUX)
+                return AudioProcessingModule::Processors{{{&this->fluxDetectors_[I]}...}};
+#else
+                return AudioProcessingModule::Processors{{{&this->beatDetectors_[I]}...}};
+#endif
+            }(std::make_index_sequence<Constants::AnalysedChannelCount>());
+        }
+
+    private:
+        AnalysisFft fftProcessor_{};
+#if !defined(CONFIG_APP_BEAT_ENGINE_SPECTRAL_FLUX)
+        std::array<AnalysisFrontEnd, Constants::AnalysedChannelCount> energyFrontEnds_{};
+        std::array<AnalysisBeatDetector, Constants::AnalysedChannelCount> beatDetectors_ =
+            [this]<size_t... I>(std::index_sequence<I...>)
+            {
+                return std::array{AnalysisBeatDetector(this->fftProcessor_, this->energyFrontEnds_[I])...};
+            }(std::make_index_sequence<Constants::AnalysedChannelCount>());
+#endif
+#if defined(CONFIG_APP_BEAT_ENGINE_SPECTRAL_FLUX) || defined(CONFIG_APP_BEAT_ENGINE_RUNTIME)
+        std::array<AnalysisFrontEnd, Constants::AnalysedChannelCount> fluxFrontEnds_{};
+        std::array<AnalysisSpectralFluxDetector, Constants::AnalysedChannelCount> fluxDetectors_ =
+            [this]<size_t... I>(std::index_sequence<I...>)
+            {
+                return std::array{AnalysisSpectralFluxDetector(this->fftProcessor_, this->fluxFrontEnds_[I])...};
+            }(std::make_index_sequence<Constants::AnalysedChannelCount>());
+#endif
+    };
+}
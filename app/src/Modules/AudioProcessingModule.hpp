@@ -4,32 +4,53 @@
 
 #pragma once
 
+#include "Utils/DurationStats.hpp"
+#include "Utils/LatencyTracer.hpp"
 #include "Utils/Logger.hpp"
+#include "SignalProcessing/AutoGain.hpp"
 #include "SignalProcessing/BeatDetector.hpp"
+#include "SignalProcessing/TempoTracker.hpp"
 #include "arm_math.h"
 #include "Core/EventTypes.hpp"
+#include "zephyr/timing/timing.h"
 
 using namespace SignalProcessing;
+using namespace Utils;
 
 namespace Modules
 {
     class AudioProcessingModule final
     {
     public:
-        AudioProcessingModule(AppPublisher& publisher, AppSubscriber& subscriber,
-                        SignalProcessingBase& signalProcessor, Logger& logger)
-            : logger_(logger), signalProcessor_(signalProcessor), publisher_(publisher), subscriber_(subscriber)
+        // all engines built into this image (CONFIG_APP_BEAT_ENGINE_*), in BeatEngine order
+        static constexpr size_t EngineCount = IS_ENABLED(CONFIG_APP_BEAT_ENGINE_RUNTIME) ? 2 : 1;
+        enum class BeatEngine : uint8_t { BandEnergy, SpectralFlux };
+
+        // per analysed channel (one for the mono downmix, or one per ADC channel with
+        // CONFIG_APP_AUDIO_PER_CHANNEL_ANALYSIS): one processor per engine
+        using Processors = std::array<std::array<SignalProcessingBase<>*, EngineCount>, Constants::AnalysedChannelCount>;
+
+        AudioProcessingModule(AppPublisher& publisher, AppSubscriber& subscriber, Core::AudioFramePool& pool,
+                        const Processors& signalProcessors, LatencyTracer& latency, Logger& logger)
+            : logger_(logger), signalProcessors_(signalProcessors), pool_(pool), latency_(latency),
+              publisher_(publisher), subscriber_(subscriber)
         {
         }
 
         void Initialize()
         {
             timing_init();
-            auto ret = signalProcessor_.Initialize();
-            if (ret != ARM_MATH_SUCCESS)
+            for (const auto& engines : signalProcessors_)
             {
-                this->logger_.error("FFT module could not be initialized: %d.", ret);
-                return;
+                for (auto* signalProcessor : engines)
+                {
+                    auto ret = signalProcessor->Initialize();
+                    if (ret != ARM_MATH_SUCCESS)
+                    {
+                        this->logger_.error("FFT module could not be initialized: %d.", ret);
+                        return;
+                    }
+                }
             }
 
             this->logger_.info("Processing module initialized.");
@@ -38,34 +59,229 @@ namespace Modules
         void Start()
         {
             timing_start();
-            subscriber_.Subscribe<Core::EventTypes::AudioFrame>([&](Core::EventTypes::AudioFrame& event)
+            int failed = 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::AudioFrame>([&](Core::EventTypes::AudioFrame& event)
             {
                 Notify(event);
-            });
+            }) != 0;
+            if constexpr (EngineCount > 1)
+            {
+                failed += subscriber_.Subscribe<Core::EventTypes::ButtonEvent>([&](const Core::EventTypes::ButtonEvent& event)
+                {
+                    if (event.state == UtilsButton::ButtonState::ReleasedLong)
+                    {
+                        SelectEngine(static_cast<BeatEngine>((atomic_get(&this->engine_) + 1) % EngineCount));
+                    }
+                }) != 0;
+            }
+            if (failed != 0)
+            {
+                this->logger_.error("%d subscription(s) failed.", failed);
+            }
             this->logger_.info("Processing module started.");
         }
 
+        // Only with CONFIG_APP_BEAT_ENGINE_RUNTIME; the engines not selected keep their (stale) history.
+        void SelectEngine(const BeatEngine engine)
+        {
+            if (static_cast<size_t>(engine) >= EngineCount)
+            {
+                this->logger_.error("Beat engine %u not built in.", static_cast<unsigned>(engine));
+                return;
+            }
+            atomic_set(&this->engine_, static_cast<atomic_val_t>(engine));
+            this->logger_.info("Beat engine: %s.", engine == BeatEngine::BandEnergy ? "band energy" : "spectral flux");
+        }
+
     protected:
         void Notify(Core::EventTypes::AudioFrame& event)
         {
-            auto beat = this->signalProcessor_.Process(event.samples);
-            if (!beat)
+            const auto* samples = this->pool_.Retain(event.frame);
+            if (samples == nullptr)
+            {
+                // the frame was recycled before we got to it
+                return;
+            }
+            const auto received = Timestamp::Now();
+            this->latency_.Record(LatencyStage::Acquisition, received.nSec - event.ts.nSec);
+
+            auto start = timing_counter_get();
+            const auto engine = static_cast<size_t>(atomic_get(&this->engine_));
+            uint8_t channels = 0;
+            BeatMask bands = 0;
+            if constexpr (IS_ENABLED(CONFIG_APP_AUDIO_PER_CHANNEL_ANALYSIS))
+            {
+                for (size_t c = 0; c < this->signalProcessors_.size(); ++c)
+                {
+                    const auto beats = this->signalProcessors_[c][engine]->Process(Condition(c, (*samples)[c]));
+                    channels |= beats ? BIT(c) : 0;
+                    bands |= beats;
+                }
+            }
+            else
+            {
+                bands = this->signalProcessors_[0][engine]->Process(Condition(0, Downmix(*samples, this->mono_)));
+                channels = bands ? 1 : 0;
+            }
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+            TrackTempo(engine, event.ts);
+#endif
+#if defined(CONFIG_APP_SPECTRUM_EVENTS)
+            PublishSpectrum(engine, event.ts);
+#endif
+            auto end = timing_counter_get();
+            this->pool_.Release(event.frame);
+            ReportLoad(timing_cycles_to_ns(timing_cycles_get(&start, &end)));
+
+            if (channels == 0)
             {
                 return;
             }
             auto beatEvent = Core::EventTypes::BeatEvent();
-            auto timestamp = Timestamp();
-            timestamp.nSec = timing_cycles_to_ns(timing_counter_get());
-            beatEvent.ts = timestamp;
+            beatEvent.captured = event.ts;
+            beatEvent.sequence = event.sequence;
+            beatEvent.channels = channels;
+            for (size_t b = 0; b < beatEvent.bands.size(); ++b)
+            {
+                beatEvent.bands[b] = bands & BIT(b);
+            }
+            beatEvent.ts = Timestamp::Now();
             if (const auto err = publisher_.Publish(beatEvent))
             {
                 this->logger_.error("Error publishing beat event: %d", err);
+                return;
             }
+            this->latency_.Record(LatencyStage::Detection, beatEvent.ts.nSec - received.nSec);
         }
 
+        // AGC of one analysed channel (CONFIG_APP_AUTO_GAIN); the pooled frame itself stays untouched
+        const SampleFrame& Condition(const size_t channel, const SampleFrame& samples)
+        {
+            if constexpr (!IS_ENABLED(CONFIG_APP_AUTO_GAIN))
+            {
+                return samples;
+            }
+            this->gain_[channel].Process(samples, this->conditioned_);
+            return this->conditioned_;
+        }
+
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+        // Feeds the strongest onset of all analysed channels to the tracker, publishes every new estimate.
+        void TrackTempo(const size_t engine, const Timestamp& captured)
+        {
+            float onset = 0.0f;
+            for (const auto& engines : this->signalProcessors_)
+            {
+                onset = max(onset, engines[engine]->OnsetStrength());
+            }
+            if (!this->tempo_.Update(onset, captured))
+            {
+                return;
+            }
+
+            const auto& estimate = this->tempo_.Get();
+            auto tempoEvent = Core::EventTypes::TempoEvent();
+            tempoEvent.bpm = estimate.bpm;
+            tempoEvent.confidence = estimate.confidence;
+            tempoEvent.nextBeat = estimate.nextBeat;
+            tempoEvent.period_ns = estimate.period_ns;
+            tempoEvent.ts = Timestamp::Now();
+            if (const auto err = publisher_.Publish(tempoEvent))
+            {
+                this->logger_.error("Error publishing tempo event: %d", err);
+            }
+        }
+#endif
+
+#if defined(CONFIG_APP_SPECTRUM_EVENTS)
+        // Spectrum of the first analysed channel, every SpectrumHops hops. Latest value wins, so a
+        // failed publish is not worth reporting: the next one replaces it anyway.
+        void PublishSpectrum(const size_t engine, const Timestamp& captured)
+        {
+            if (++this->spectrumHop_ < SpectrumHops)
+            {
+                return;
+            }
+            this->spectrumHop_ = 0;
+
+            auto spectrumEvent = Core::EventTypes::SpectrumEvent();
+            this->signalProcessors_[0][engine]->GetSpectrum(spectrumEvent.levels);
+            spectrumEvent.sequence = ++this->spectrumSequence_;
+            spectrumEvent.ts = captured;
+            (void)publisher_.Publish(spectrumEvent);
+        }
+
+        static constexpr uint32_t HopRate_hz = Constants::SampleRate_hz / Constants::SamplingFrameSize;
+        static constexpr uint32_t SpectrumHops =
+            HopRate_hz > CONFIG_APP_SPECTRUM_RATE_HZ ? HopRate_hz / CONFIG_APP_SPECTRUM_RATE_HZ : 1;
+#endif
+
+        // Processing time per hop relative to the hop period, to pick the hop size per board.
+        void ReportLoad(const uint64_t ns)
+        {
+            this->processing_ns_.Add(ns);
+            if (this->processing_ns_.Count() < LoadReportHops)
+            {
+                return;
+            }
+
+            constexpr uint64_t hopPeriod_ns = Constants::SamplingFrameSize * Constants::SamplingInterval_us * 1000ULL;
+            this->logger_.info("hop %u/%u (1/%u): %llu us avg, %llu us max per hop, load %llu.%llu%%",
+                               static_cast<unsigned>(Constants::AnalysisHopSize),
+                               static_cast<unsigned>(Constants::AnalysisWindowSize),
+                               static_cast<unsigned>(Constants::DecimationFactor),
+                               this->processing_ns_.Avg() / 1000, this->processing_ns_.Max() / 1000,
+                               this->processing_ns_.Avg() * 100 / hopPeriod_ns,
+                               this->processing_ns_.Avg() * 1000 / hopPeriod_ns % 10);
+            this->processing_ns_.Reset();
+            this->latency_.Report(this->logger_);
+            for (size_t lane = 0; lane < this->subscriber_.LaneCount(); ++lane)
+            {
+                const auto stats = this->subscriber_.Stats(lane);
+                this->logger_.info("lane %u: %u messages, queue max %u, handlers max %u us",
+                                   static_cast<unsigned>(lane), stats.dispatched, stats.maxQueued,
+                                   stats.maxHandler_us);
+            }
+            const auto frames = this->subscriber_.Stats<Core::EventTypes::AudioFrame>();
+            const auto beats = this->subscriber_.Stats<Core::EventTypes::BeatEvent>();
+            this->logger_.info("frames %u delivered, %u dropped, %u duplicate; beats %u delivered, %u dropped",
+                               frames.delivered, frames.dropped, frames.duplicates, beats.delivered, beats.dropped);
+            if constexpr (IS_ENABLED(CONFIG_APP_AUTO_GAIN))
+            {
+                for (size_t c = 0; c < this->gain_.size(); ++c)
+                {
+                    this->logger_.info("agc %u: input %d dB, gain %d dB", static_cast<unsigned>(c),
+                                       static_cast<int>(20.0f * log10f(max(this->gain_[c].InputRms(), 1e-6f))),
+                                       static_cast<int>(20.0f * log10f(this->gain_[c].Gain())));
+                }
+            }
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+            const auto& estimate = this->tempo_.Get();
+            this->logger_.info("tempo %u.%u BPM, confidence %u%%", static_cast<unsigned>(estimate.bpm),
+                               static_cast<unsigned>(estimate.bpm * 10.0f) % 10,
+                               static_cast<unsigned>(estimate.confidence * 100.0f));
+#endif
+        }
+
+        static constexpr uint32_t LoadReportHops = 500;
+
         Logger& logger_;
+        DurationStats processing_ns_{};
 
-        SignalProcessingBase& signalProcessor_;
+        Processors signalProcessors_;
+        atomic_t engine_{ATOMIC_INIT(0)};
+        SampleFrame mono_{};
+        SampleFrame conditioned_{};
+        std::array<AnalysisAutoGain, Constants::AnalysedChannelCount> gain_{};
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+        TempoTracker tempo_{};
+#endif
+#if defined(CONFIG_APP_SPECTRUM_EVENTS)
+        uint32_t spectrumHop_ = 0;
+        uint32_t spectrumSequence_ = 0;
+#endif
+        Core::AudioFramePool& pool_;
+        LatencyTracer& latency_;
         AppPublisher& publisher_;
         AppSubscriber& subscriber_;
     };
@@ -5,44 +5,70 @@
 #pragma once
 
 #include "Modules/ModuleBase.hpp"
-#include "ADC/AdcReader.hpp"
+#include "ADC/IAudioSource.hpp"
 #include "Core/EventTypes.hpp"
+#include "Utils/Logger.hpp"
 
 namespace Modules
 {
     class AudioSamplingModule final : ModuleBase
     {
     public:
-        explicit AudioSamplingModule(Adc::AdcReader& reader, AppPublisher& publisher, AppSubscriber &subscriber,
-                               Logger& logger)
-            : ModuleBase(publisher, subscriber), reader_(reader), logger_(logger)
+        explicit AudioSamplingModule(Adc::IAudioSource& source, Core::AudioFramePool& pool, AppPublisher& publisher,
+                                     AppSubscriber& subscriber, Logger& logger)
+            : ModuleBase(publisher, subscriber), source_(source), pool_(pool), logger_(logger)
         {
         }
 
         void Initialize()
         {
-            this->reader_.Initialize(Constants::SamplingInterval_us);
+            this->source_.Initialize();
             ModuleBase::Initialize();
         }
 
-        void Start() const
+        void Start()
         {
-            this->reader_.Start([this](const int sample_rate_hz, const array<float, Constants::SamplingFrameSize>& frame)
+            this->source_.Start([this](const int sample_rate_hz, const Core::FrameHandle& frame,
+                                const Timestamp& captured)
             {
+                auto audioFrame = Core::EventTypes::AudioFrame();
+                audioFrame.ts = captured;
                 audioFrame.sample_rate_hz = sample_rate_hz;
-                audioFrame.samples = frame;
+                audioFrame.sequence = this->sequence_++;
+                audioFrame.frame = frame;
 
-                if (const auto err = publisher_.Publish(audioFrame))
+                const auto err = publisher_.Publish(audioFrame);
+                if (publisher_.TakesReference<Core::EventTypes::AudioFrame>())
+                {
+                    // a ring topic releases the frame after its handlers ran, or now if it was full
+                    if (err)
+                    {
+                        this->logger_.error("failed to publish audio frame: %d", err);
+                    }
+                    return;
+                }
+                if (err)
                 {
                     this->logger_.error("failed to publish audio frame: %d", err);
+                    this->pool_.Release(frame);
+                    return;
                 }
-            });
+
+                // the channel now holds the reference to this frame; drop the one it held before
+                this->pool_.Release(this->published_);
+                this->published_ = frame;
+            }, AcquisitionThreadPriority);
 
             this->logger_.info("Audio sampling module started.");
         }
 
-        Adc::AdcReader& reader_;
-        inline static Core::EventTypes::AudioFrame audioFrame{};
+        static constexpr int AcquisitionThreadPriority = 0;
+
+        Adc::IAudioSource& source_;
+        Core::AudioFramePool& pool_;
         Logger& logger_;
+
+        Core::FrameHandle published_{};
+        uint32_t sequence_{0};
     };
 }
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <cstdlib>
+
+#include "ADC/ReplayOptions.hpp"
+#include "Core/EventTypes.hpp"
+#include "Modules/ModuleBase.hpp"
+#include "Utils/Logger.hpp"
+
+extern "C" {
+#include <native_rtc.h>
+#include <nsi_host_trampolines.h>
+#include <nsi_main.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/printk.h>
+}
+
+namespace Modules
+{
+    /**
+     * native_sim with CONFIG_APP_PCM_REPLAY only: scores the detected kick beats (band 0) of a
+     * replayed track against its ground-truth beat times, so sensitivity, history length and band
+     * limits can be tuned on a corpus instead of by ear.
+     *
+     * Beats are placed in file time by the frame they were detected in (BeatEvent::sequence, the
+     * replay delivers at Constants::SampleRate_hz), so the result is the same in real time and
+     * as-fast-as-possible replay. A detection matches the
+     * nearest unmatched annotation within +-Tolerance_ms (the usual MIREX window). Latency runs from
+     * the annotated beat to the end of the frame that reported it, i.e. without the device's
+     * processing time; ns/frame is host wall clock for the whole ADC->zbus->DSP path.
+     *
+     * Finish() prints one JSON line on stdout and exits the simulator, so a corpus is one loop over
+     * zephyr.exe invocations (scripts/beat_evaluation.py).
+     *
+     * Frames and beats arrive on different lanes and Finish() runs on the replay thread: the
+     * counters are shared under lock_.
+     */
+    class BeatEvaluationModule final
+    {
+    public:
+        BeatEvaluationModule(AppSubscriber& subscriber, const Adc::ReplayOptions& options, Logger& logger)
+            : logger_(logger), subscriber_(subscriber), options_(options)
+        {
+        }
+
+        void Initialize()
+        {
+            this->track_ = this->options_.track;
+            this->annotations_ = this->options_.beats;
+            if (const auto res = ReadAnnotations(); res != 0)
+            {
+                this->logger_.error("Cannot read beat annotations %s: %d.", this->annotations_, res);
+                return;
+            }
+            this->logger_.info("%u annotated beats in %s.", static_cast<unsigned>(this->annotated_),
+                               this->annotations_);
+        }
+
+        void Start()
+        {
+            int failed = 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::AudioFrame>([&](const Core::EventTypes::AudioFrame&)
+            {
+                const auto now_us = native_rtc_gettime_us(RTC_CLOCK_REALTIME);
+                const auto key = k_spin_lock(&this->lock_);
+                if (this->frames_++ == 0)
+                {
+                    this->first_us_ = now_us;
+                }
+                this->last_us_ = now_us;
+                k_spin_unlock(&this->lock_, key);
+            }) != 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::BeatEvent>([&](const Core::EventTypes::BeatEvent& event)
+            {
+                if (event.bands[0])
+                {
+                    const auto key = k_spin_lock(&this->lock_);
+                    Score(event.sequence);
+                    k_spin_unlock(&this->lock_, key);
+                }
+            }) != 0;
+            if (failed != 0)
+            {
+                this->logger_.error("%d subscription(s) failed.", failed);
+            }
+        }
+
+        // Called once the replay reached the end of the track and its last frame was processed.
+        void Finish()
+        {
+            const auto key = k_spin_lock(&this->lock_);
+            const float precision = this->detected_ ? static_cast<float>(this->matched_) / this->detected_ : 0.0f;
+            const float recall = this->annotated_ ? static_cast<float>(this->matched_) / this->annotated_ : 0.0f;
+            const float fMeasure = precision + recall > 0.0f ? 2.0f * precision * recall / (precision + recall) : 0.0f;
+            const uint64_t wall_ns = this->frames_ > 1
+                                         ? (this->last_us_ - this->first_us_) * 1000 / (this->frames_ - 1)
+                                         : 0;
+
+            printk("{\"track\":\"%s\",\"engine\":\"%s\",\"frames\":%u,\"annotated\":%u,\"detected\":%u,"
+                   "\"matched\":%u,\"precision\":%.4f,\"recall\":%.4f,\"f_measure\":%.4f,"
+                   "\"latency_ms\":{\"mean\":%.2f,\"min\":%.2f,\"max\":%.2f},\"ns_per_frame\":%llu}\n",
+                   this->track_, EngineName(), this->frames_, static_cast<unsigned>(this->annotated_),
+                   this->detected_, this->matched_, static_cast<double>(precision), static_cast<double>(recall),
+                   static_cast<double>(fMeasure),
+                   this->matched_ ? static_cast<double>(this->latencySum_ms_ / this->matched_) : 0.0,
+                   static_cast<double>(this->latencyMin_ms_), static_cast<double>(this->latencyMax_ms_),
+                   wall_ns);
+            k_spin_unlock(&this->lock_, key);
+            nsi_exit(0);
+        }
+
+    private:
+        static constexpr float Tolerance_ms = 70.0f;
+        static constexpr size_t MaxAnnotations = 4096; // ~30 min at 140 BPM
+        static constexpr int HostReadOnly = 0; // O_RDONLY on the host
+        static constexpr float Frame_ms = 1000.0f * Constants::SamplingFrameSize / Constants::SampleRate_hz;
+
+        static const char* EngineName()
+        {
+            if constexpr (IS_ENABLED(CONFIG_APP_BEAT_ENGINE_SPECTRAL_FLUX))
+            {
+                return "spectral_flux";
+            }
+            return "band_energy";
+        }
+
+        // with lock_ held
+        void Score(const uint32_t sequence)
+        {
+            ++this->detected_;
+            const float start_ms = static_cast<float>(sequence) * Frame_ms;
+
+            // nearest unmatched annotation within the window of the frame's span
+            size_t best = this->annotated_;
+            float bestDistance = Tolerance_ms;
+            while (this->next_ < this->annotated_ && this->beats_ms_[this->next_] < start_ms - Tolerance_ms)
+            {
+                ++this->next_;
+            }
+            const float end_ms = start_ms + Frame_ms;
+            for (size_t i = this->next_; i < this->annotated_ && this->beats_ms_[i] <= end_ms + Tolerance_ms; ++i)
+            {
+                const float beat = this->beats_ms_[i];
+                const float distance = beat < start_ms ? start_ms - beat : beat > end_ms ? beat - end_ms : 0.0f;
+                if (distance <= bestDistance && !this->matchedBeat_[i])
+                {
+                    best = i;
+                    bestDistance = distance;
+                }
+            }
+            if (best == this->annotated_)
+            {
+                return;
+            }
+
+            this->matchedBeat_[best] = true;
+            ++this->matched_;
+            const float latency = end_ms - this->beats_ms_[best];
+            this->latencySum_ms_ += latency;
+            const bool first = this->matched_ == 1;
+            this->latencyMin_ms_ = first || latency < this->latencyMin_ms_ ? latency : this->latencyMin_ms_;
+            this->latencyMax_ms_ = first || latency > this->latencyMax_ms_ ? latency : this->latencyMax_ms_;
+        }
+
+        // One beat per line, time in seconds in the first column (.beats / .txt as in the common
+        // beat tracking datasets); '#' starts a comment line. Times must be ascending.
+        int ReadAnnotations()
+        {
+            const int fd = nsi_host_open(this->annotations_, HostReadOnly);
+            if (fd < 0)
+            {
+                return -ENOENT;
+            }
+
+            std::array<char, 64> line{};
+            size_t length = 0;
+            bool comment = false;
+            std::array<char, 256> chunk{};
+            long got = 0;
+            while ((got = nsi_host_read(fd, chunk.data(), chunk.size())) > 0)
+            {
+                for (long i = 0; i < got; ++i)
+                {
+                    const char c = chunk[i];
+                    if (c == '\n' || c == '\r')
+                    {
+                        if (!comment)
+                        {
+                            AddAnnotation(line.data(), length);
+                        }
+                        length = 0;
+                        comment = false;
+                        continue;
+                    }
+                    comment = comment || (length == 0 && c == '#');
+                    if (length + 1 < line.size())
+                    {
+                        line[length++] = c;
+                    }
+                }
+            }
+            if (!comment)
+            {
+                AddAnnotation(line.data(), length);
+            }
+            nsi_host_close(fd);
+            return this->annotated_ > 0 ? 0 : -EINVAL;
+        }
+
+        void AddAnnotation(char* line, const size_t length)
+        {
+            line[length] = '\0';
+            char* end = nullptr;
+            const float seconds = strtof(line, &end);
+            if (end == line || this->annotated_ >= MaxAnnotations)
+            {
+                return;
+            }
+            this->beats_ms_[this->annotated_++] = seconds * 1000.0f;
+        }
+
+        Logger& logger_;
+        AppSubscriber& subscriber_;
+        const Adc::ReplayOptions& options_;
+        const char* track_{};
+        const char* annotations_{};
+        k_spinlock lock_{};
+
+        std::array<float, MaxAnnotations> beats_ms_{};
+        std::array<bool, MaxAnnotations> matchedBeat_{};
+        size_t annotated_ = 0;
+        size_t next_ = 0;
+
+        uint32_t frames_ = 0;
+        uint64_t first_us_ = 0;
+        uint64_t last_us_ = 0;
+
+        uint32_t detected_ = 0;
+        uint32_t matched_ = 0;
+        float latencySum_ms_ = 0.0f;
+        float latencyMin_ms_ = 0.0f;
+        float latencyMax_ms_ = 0.0f;
+    };
+}
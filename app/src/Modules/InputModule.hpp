@@ -17,16 +17,11 @@ namespace Modules
 
         int Initialize() const
         {
-            timing_init();
-            timing_start();
             const auto ret = this->button_.Initialize([this](const UtilsButton::ButtonState evt)
             {
                 logger_.info("button pressed: %d", evt);
                 auto buttonEvent = Core::EventTypes::ButtonEvent();
-                auto timestamp = Timestamp();
-                timestamp.nSec = timing_cycles_to_ns(timing_counter_get());
-
-                buttonEvent.ts = timestamp;
+                buttonEvent.ts = Timestamp::Now();
                 buttonEvent.state = evt;
                 if (const auto err = publisher_.Publish(buttonEvent))
                 {
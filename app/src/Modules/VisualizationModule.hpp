@@ -6,6 +6,7 @@
 
 #include "Animations/AnimationControl.hpp"
 #include "Core/EventTypes.hpp"
+#include "Utils/LatencyTracer.hpp"
 #include "Utils/LoadSwitch.hpp"
 
 namespace Modules
@@ -14,8 +15,10 @@ namespace Modules
     {
     public:
         VisualizationModule(AppSubscriber& subscriber, Logger& logger,
-                            Animations::AnimationControl& animationControl, LoadSwitch &loadSwitch)
-            : logger_(logger), animation_control_(animationControl), subscriber_(subscriber), load_switch_(loadSwitch)
+                            Animations::AnimationControl& animationControl, LoadSwitch &loadSwitch,
+                            LatencyTracer& latency)
+            : logger_(logger), animation_control_(animationControl), subscriber_(subscriber), load_switch_(loadSwitch),
+              latency_(latency)
         {
         }
 
@@ -27,33 +30,51 @@ namespace Modules
         void Start()
         {
             animation_control_.Start(10'000);
-            subscriber_.Subscribe<Core::EventTypes::BeatEvent>([&](const Core::EventTypes::BeatEvent& event)
+            int failed = 0;
+            failed += subscriber_.Subscribe<Core::EventTypes::BeatEvent>([&](const Core::EventTypes::BeatEvent& event)
             {
-                Notify();
-            });
-            subscriber_.Subscribe<Core::EventTypes::ButtonEvent>([&](const Core::EventTypes::ButtonEvent& event)
+                Notify(event);
+            }) != 0;
+#if defined(CONFIG_APP_TEMPO_PREDICTION)
+            failed += subscriber_.Subscribe<Core::EventTypes::TempoEvent>([&](const Core::EventTypes::TempoEvent& event)
+            {
+                animation_control_.ProcessTempo(event.nextBeat, event.period_ns, event.confidence);
+            }) != 0;
+#endif
+#if defined(CONFIG_APP_SPECTRUM_EVENTS)
+            failed += subscriber_.Subscribe<Core::EventTypes::SpectrumEvent>([&](const Core::EventTypes::SpectrumEvent& event)
+            {
+                animation_control_.ProcessSpectrum(event.levels);
+            }) != 0;
+#endif
+            failed += subscriber_.Subscribe<Core::EventTypes::ButtonEvent>([&](const Core::EventTypes::ButtonEvent& event)
             {
                 logger_.info("Button event: %d", event.state);
                 if (event.state == UtilsButton::ButtonState::ReleasedShort)
                 {
                     animation_control_.IterateAnimation();
                 }
-            });
+            }) != 0;
+            if (failed != 0)
+            {
+                this->logger_.error("%d subscription(s) failed.", failed);
+            }
             load_switch_.Close();
             this->logger_.info("Visualization module started.");
         }
 
     private:
-        void Notify()
+        void Notify(const Core::EventTypes::BeatEvent& event)
         {
-            animation_control_.ProcessNextBeat();
+            // the next strip update is the first one that can show this beat
+            latency_.BeatDispatched(event.captured, event.ts);
+            animation_control_.ProcessNextBeat(event.bands);
         }
 
         Logger& logger_;
-
-        float last_event_ms_ = 0;
         Animations::AnimationControl& animation_control_;
         AppSubscriber& subscriber_;
         LoadSwitch &load_switch_;
+        LatencyTracer& latency_;
     };
 }
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ConstexprMath.hpp"
+#include "SampleFormat.hpp"
+
+namespace SignalProcessing
+{
+    /**
+     * Automatic gain control with a peak limiter for frames of FrameSize samples at SampleRateHz,
+     * run on every frame before the detectors.
+     *
+     * The gain follows TargetRms / frame RMS with an attack (gain going down) over several frames
+     * and a slow release (gain going up); frames below NoiseFloorRms hold it, so silence is not
+     * pumped up to MaxGain. A frame is scaled with the gain of the frames before it and only then
+     * updates it: a kick keeps its energy jump against the previous frames, which is what the
+     * detectors look for. Its peak is left to the limiter, which knows the whole frame before it is
+     * scaled and caps the gain to keep it below Ceiling: one frame of look-ahead without extra
+     * latency.
+     */
+    template <int SampleRateHz, size_t FrameSize>
+    class AutoGain
+    {
+    public:
+        using Frame = std::array<Constants::AudioSample, FrameSize>;
+
+        static constexpr float TargetRms = 0.1f; // -20 dB re. 1.0
+        static constexpr float Ceiling = 0.9f;
+        static constexpr float MinGain = 0.25f; // -12 dB
+        static constexpr float MaxGain = 100.0f; // +40 dB
+        static constexpr float NoiseFloorRms = 1e-4f; // -80 dB
+        static constexpr double Attack_ms = 100.0;
+        static constexpr double Release_ms = 500.0;
+
+        void Process(const Frame& input, Frame& output)
+        {
+            float rms = 0.0f;
+            float peak = 0.0f;
+            FrameLevels(input, rms, peak);
+            this->inputRms_ = rms;
+
+            // look-ahead limiter: this frame's peak is already known
+            this->applied_ = peak * this->gain_ > Ceiling ? Ceiling / peak : this->gain_;
+            Scale(input, output, this->applied_);
+
+            if (rms > NoiseFloorRms)
+            {
+                float wanted = TargetRms / rms;
+                wanted = wanted < MinGain ? MinGain : wanted > MaxGain ? MaxGain : wanted;
+                this->gain_ += (wanted < this->gain_ ? AttackAlpha : ReleaseAlpha) * (wanted - this->gain_);
+            }
+        }
+
+        // gain applied to the last frame
+        float Gain() const { return this->applied_; }
+
+        // RMS of the last frame before the gain, in the unit of the float path
+        float InputRms() const { return this->inputRms_; }
+
+    private:
+        static constexpr double FramePeriod_ms = 1000.0 * FrameSize / SampleRateHz;
+        static_assert(Attack_ms >= 4 * FramePeriod_ms, "the attack must span several frames, peaks are the limiter's");
+        // per-frame smoothing factors of the one-pole attack and release
+        static constexpr float AttackAlpha = static_cast<float>(1.0 - ConstexprMath::Exp(-FramePeriod_ms / Attack_ms));
+        static constexpr float ReleaseAlpha = static_cast<float>(1.0 - ConstexprMath::Exp(-FramePeriod_ms / Release_ms));
+
+        static void Scale(const Frame& input, Frame& output, const float gain)
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            // gain = fract * 2^shift with fract < 1.0; arm_scale_q15 saturates
+            int8_t shift = 0;
+            float fract = gain;
+            while (fract >= 1.0f)
+            {
+                fract /= 2.0f;
+                ++shift;
+            }
+            const float scaled = fract * 32768.0f;
+            arm_scale_q15(input.data(), static_cast<q15_t>(scaled >= 32767.0f ? 32767.0f : scaled), shift,
+                          output.data(), FrameSize);
+#else
+            arm_scale_f32(input.data(), gain, output.data(), FrameSize);
+#endif
+        }
+
+        float gain_ = 1.0f;
+        float applied_ = 1.0f;
+        float inputRms_ = 0.0f;
+    };
+
+    using AnalysisAutoGain = AutoGain<Constants::SampleRate_hz, Constants::SamplingFrameSize>;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace SignalProcessing
+{
+    struct BandSpec
+    {
+        float lo_hz;
+        float hi_hz;
+        float sensitivity; // threshold in standard deviations above the band's average energy
+        uint16_t refractory_ms; // no further beat in this band for this long after one was detected
+    };
+
+    /**
+     * Frequency bands with their own beat detection, lowest first. Bands must not overlap and have
+     * to end below the analysis Nyquist frequency; band b is reported as BeatEvent::bands[b].
+     */
+#if defined(CONFIG_APP_DSP_DECIMATION)
+    // the decimated analysis band ends at 625 Hz: no hi-hats
+    inline constexpr std::array BeatBands{
+        BandSpec{30.0f, 140.0f, 0.9f, 150}, // kick
+        BandSpec{150.0f, 500.0f, 1.2f, 100}, // snare body
+    };
+#else
+    inline constexpr std::array BeatBands{
+        BandSpec{30.0f, 140.0f, 0.9f, 150}, // kick
+        BandSpec{150.0f, 500.0f, 1.2f, 100}, // snare body
+        // hi-hat / cymbals, up to just below Nyquist. Snare noise sets most of the band's variance:
+        // 2.5 deviations keep every snare hit and leave a bare noise floor quiet.
+        BandSpec{2500.0f, 4800.0f, 2.5f, 60},
+    };
+#endif
+
+    static_assert(BeatBands.size() == Constants::BeatBandCount, "update Constants::BeatBandCount");
+    static_assert(BeatBands.size() <= 8, "bands are reported as a bit mask");
+
+    constexpr bool BandsValid()
+    {
+        for (size_t b = 0; b < BeatBands.size(); ++b)
+        {
+            if (BeatBands[b].lo_hz >= BeatBands[b].hi_hz ||
+                BeatBands[b].hi_hz > Constants::AnalysisSampleRate_hz / 2.0f)
+            {
+                return false;
+            }
+            if (b > 0 && BeatBands[b].lo_hz < BeatBands[b - 1].hi_hz)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(BandsValid(), "beat bands must be ordered, disjoint and below the analysis Nyquist frequency");
+
+    // A band in FFT bins [lo, hi) with its refractory period in hops, for one analysis configuration.
+    struct BandBins
+    {
+        size_t lo;
+        size_t hi;
+        uint32_t refractoryHops;
+    };
+
+    template <typename Fft, size_t HopSize>
+    constexpr std::array<BandBins, BeatBands.size()> MakeBandBins()
+    {
+        std::array<BandBins, BeatBands.size()> bins{};
+        for (size_t b = 0; b < BeatBands.size(); ++b)
+        {
+            bins[b] = {Fft::Bin(BeatBands[b].lo_hz), Fft::BinEdge(BeatBands[b].hi_hz),
+                       static_cast<uint32_t>(BeatBands[b].refractory_ms * static_cast<uint64_t>(Fft::SampleRate_hz) /
+                           (1000u * HopSize))};
+        }
+        return bins;
+    }
+
+    // every band has to cover at least one bin the FFT does not blank
+    template <typename Fft>
+    constexpr bool BandBinsValid(const std::array<BandBins, BeatBands.size()>& bins)
+    {
+        for (const auto& band : bins)
+        {
+            if (band.lo < Fft::FirstUsableBin || band.hi > Fft::LastUsableBin + 1 || band.lo >= band.hi)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -4,23 +4,35 @@
 
 #pragma once
 
+#include <algorithm>
+
+#include "BeatBands.hpp"
+#include "Decimator.hpp"
 #include "FftProcessor.hpp"
+#include "LogSpectrum.hpp"
 #include "SignalProcessingBase.hpp"
-#include "LpFilter.hpp"
+#include "SlidingWindow.hpp"
+#include "Utils/StreamingStats.hpp"
 
 namespace SignalProcessing
 {
-    class BeatDetector final : public SignalProcessingBase
+    /**
+     * Band energy beat detector behind FrontEnd (see AnalysisFrontEnd), with an FFT over WindowSize
+     * samples at the front end's output rate, advanced by one front end output (hop) per input frame.
+     * Band bins, refractory periods and the history length are resolved at compile time.
+     */
+    template <typename FrontEnd, size_t WindowSize>
+    class BeatDetector final : public SignalProcessingBase<typename FrontEnd::Input>
     {
     public:
-        explicit BeatDetector(FftProcessor& fftProcessor, LpFilter& filter)
+        using Frame = typename FrontEnd::Input;
+        static constexpr int SampleRate_hz = FrontEnd::OutputRate_hz;
+        static constexpr size_t HopSize = std::tuple_size_v<typename FrontEnd::Output>;
+        using Fft = FftProcessor<SampleRate_hz, WindowSize>;
+
+        explicit BeatDetector(Fft& fftProcessor, FrontEnd& filter)
             : filter_(filter), fftProcessor_(fftProcessor)
         {
-            constexpr uint32_t bandSize = (Constants::SamplingFrameSize / 2 != 0u)
-                                              ? (10000 / Constants::SamplingFrameSize / 2)
-                                              : 0u;
-            lo = (bandSize ? (30 / bandSize) : 0u);
-            hi = (bandSize ? (140 / bandSize) : 0u);
         }
 
         int Initialize() override
@@ -29,111 +41,109 @@ namespace SignalProcessing
             return this->fftProcessor_.Initialize();
         }
 
-        bool Process(array<float, Constants::SamplingFrameSize>& samples) override
+        BeatMask Process(const Frame& samples) override
         {
-            /* Filter */
-            this->filter_.Process(samples, this->filterOut_);
-            this->fftProcessor_.Process(this->filterOut_, this->fft_power);
-
-            // 1) Compute band energies (average of bins in range)
-            float acc = 0.0f;
-            const size_t width = hi - lo;
-            for (size_t i = lo; i < hi; ++i) acc += isnan(this->fft_power[i]) ? 0.0f : this->fft_power[i];
-            auto band_energy = (width ? (acc / static_cast<float>(width)) : 0.0f);
-
-
-            // Get audio levels
-            float rms = 0.0f;
-            arm_rms_f32(samples.data(), samples.size(), &rms);
-            rms = rms / 32768.0f;
-
-            // Calculate peak
-            int32_t maxSample = 0;
-            for (size_t i = 0; i < Constants::SamplingFrameSize; i++)
+            /* Filter (and decimate) the new frame straight into the analysis window, then analyse the whole window */
+            this->filter_.Process(samples, this->window_.Next());
+            this->window_.Advance();
+            this->window_.CopyTo(this->fftIn_);
+            // power spectrum of the band bins only, or of everything LogSpectrum reads
+            this->fftProcessor_.Power(this->fftIn_, this->fft_power, FirstFftBin, EndFftBin);
+
+            // 1) Compute band energies (average power of the bins in range), all bands in one pass
+            std::array<float, BeatBands.size()> energy{};
+            size_t b = 0;
+            for (size_t i = Bins.front().lo; i < Bins.back().hi; ++i)
             {
-                const int32_t absSample = fabsf(samples[i]);
-                if (absSample > maxSample)
+                while (i >= Bins[b].hi)
+                {
+                    ++b;
+                }
+                if (i >= Bins[b].lo && !isnan(this->fft_power[i]))
                 {
-                    maxSample = absSample;
+                    energy[b] += this->fft_power[i];
                 }
             }
 
-            const float peak = static_cast<float>(maxSample) / 32768.0f;
-            peakLevel = peakLevel * 0.9f + peak * 0.1f; // Smooth peak
+            BeatMask beats = 0;
+            for (b = 0; b < BeatBands.size(); ++b)
+            {
+                energy[b] /= static_cast<float>(Bins[b].hi - Bins[b].lo);
+                beats |= detectBeat(this->bands_[b], Bins[b].refractoryHops, BeatBands[b].sensitivity, energy[b])
+                             ? BIT(b)
+                             : 0;
+            }
 
-            // Update auto gain
-            updateAutoGain(band_energy);
+            // rising kick energy only, sustained bass is no onset
+            this->onset_ = energy[0] > this->lastKickEnergy_ ? energy[0] - this->lastKickEnergy_ : 0.0f;
+            this->lastKickEnergy_ = energy[0];
 
-            // Beat detection
-            return detectBeat(band_energy);
+            return beats;
         }
 
-    private:
-        // Beat detection algorithm
-        bool detectBeat(float energy)
+        float OnsetStrength() const override
         {
-            beatHistory[beatHistoryIndex] = energy;
-            beatHistoryIndex = (beatHistoryIndex + 1) % hist_size;
+            return this->onset_;
+        }
 
-            // Calculate average
-            beatAverage = 0;
-            for (int i = 0; i < hist_size; i++)
-            {
-                beatAverage += beatHistory[i];
-            }
-            beatAverage /= hist_size;
+        void GetSpectrum(SpectrumLevels& levels) const override
+        {
+            Spectrum::Reduce(this->fft_power, true, levels);
+        }
 
-            // Calculate variance
-            beatVariance = 0;
-            for (int i = 0; i < hist_size; i++)
-            {
-                const float diff = beatHistory[i] - beatAverage;
-                beatVariance += diff * diff;
-            }
-            beatVariance /= hist_size;
+    private:
+        // Audio processing variables
+        static constexpr auto Bins = MakeBandBins<Fft, HopSize>();
+        static_assert(BandBinsValid<Fft>(Bins), "a beat band falls outside the usable FFT bins");
 
-            // Detect beat
-            const auto threshold = beatAverage + (beatSensitivity * sqrt(beatVariance));
+        using Spectrum = LogSpectrum<Fft, Constants::SpectrumBandCount>;
+        static constexpr bool FullSpectrum = IS_ENABLED(CONFIG_APP_SPECTRUM_EVENTS);
+        static constexpr size_t FirstFftBin = FullSpectrum ? std::min(Spectrum::FirstBin, Bins.front().lo) : Bins.front().lo;
+        static constexpr size_t EndFftBin = FullSpectrum ? std::max(Spectrum::EndBin, Bins.back().hi) : Bins.back().hi;
 
-            isBeat = energy > threshold && energy > 0.01f;
-            const auto beat = isBeat && !wasBeat;
-            wasBeat = isBeat;
-            return beat;
-        }
+        // ~2 s of history, counted in hops
+        static constexpr size_t hist_size = 2'048ULL * SampleRate_hz / (1000 * HopSize);
 
-        // Update auto gain
-        void updateAutoGain(const float level)
+        struct Band
         {
-            static float targetLevel = 0.7f;
-            static float avgLevel = 0.0f;
+            uint32_t holdoff = 0;
+            Utils::WindowedStats<hist_size> history{};
+            bool wasAbove = false;
+        };
 
-            avgLevel = avgLevel * 0.95f + level * 0.05f;
+        // Beat detection algorithm
+        static bool detectBeat(Band& band, const uint32_t refractoryHops, const float sensitivity, const float energy)
+        {
+            // mean and variance over the history, O(1) per hop
+            band.history.Add(energy);
+
+            // Detect beat: rising edge above the threshold, outside the refractory period
+            const auto threshold = band.history.Mean() + sensitivity * band.history.StdDev();
 
-            if (avgLevel > 0.01f)
+            // floor: band magnitude 0.01, as a power
+            const bool isAbove = energy > threshold && energy > 1e-4f;
+            const bool beat = isAbove && !band.wasAbove && band.holdoff == 0;
+            band.wasAbove = isAbove;
+            if (beat)
+            {
+                band.holdoff = refractoryHops;
+            }
+            else if (band.holdoff > 0)
             {
-                float gainAdjust = targetLevel / avgLevel;
-                gainAdjust = max(0.5f, min(gainAdjust, 2.0f));
-                autoGainValue = autoGainValue * 0.9f + gainAdjust * 0.1f;
+                --band.holdoff;
             }
+            return beat;
         }
 
-        // Audio processing variables
-        static constexpr int hist_size = 40;
-        float beatHistory[hist_size] = {0}; // Reduced from 43
-        int beatHistoryIndex = 0;
-        float beatAverage = 0;
-        float beatVariance = 0;
-        bool isBeat = false;
-        bool wasBeat = false;
-        float autoGainValue = 1.0f;
-        float peakLevel = 0;
-        float beatSensitivity = 0.9f;
-        array<float, Constants::SamplingFrameSize> filterOut_{};
-        array<float, Constants::SamplingFrameSize / 2> fft_power{};
-        LpFilter& filter_;
-        FftProcessor& fftProcessor_;
-
-        size_t lo = 0;
-        size_t hi = 0;
+        std::array<Band, BeatBands.size()> bands_{};
+        float lastKickEnergy_ = 0.0f;
+        float onset_ = 0.0f;
+        SlidingWindow<Constants::AudioSample, WindowSize, HopSize> window_{};
+        typename Fft::Input fftIn_{};
+        typename Fft::Output fft_power{};
+        FrontEnd& filter_;
+        Fft& fftProcessor_;
     };
+
+    using AnalysisBeatDetector = BeatDetector<AnalysisFrontEnd, Constants::AnalysisWindowSize>;
 }
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+
+#include "ConstexprMath.hpp"
+
+namespace SignalProcessing::BiquadDesign
+{
+    enum class Type : uint8_t { LowPass, HighPass, BandPass };
+
+    struct Stage
+    {
+        Type type;
+        double frequencyHz; // cut-off, or centre frequency for BandPass
+        double q;
+    };
+
+    // b0, b1, b2, a1, a2 of one stage, in the order arm_biquad_cascade_df2T expects
+    using Coefficients = std::array<float, 5>;
+
+    /**
+     * RBJ audio EQ cookbook biquad, normalised by a0 (BandPass: constant 0 dB peak gain).
+     * CMSIS adds the feedback terms, so a1 and a2 are returned negated.
+     */
+    constexpr Coefficients Design(const Stage& stage, const double sampleRateHz)
+    {
+        const double w0 = 2.0 * ConstexprMath::Pi * stage.frequencyHz / sampleRateHz;
+        const double cosW0 = ConstexprMath::Cos(w0);
+        const double alpha = ConstexprMath::Sin(w0) / (2.0 * stage.q);
+        const double a0 = 1.0 + alpha;
+
+        double b0 = 0.0;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        switch (stage.type)
+        {
+        case Type::LowPass:
+            b0 = (1.0 - cosW0) / 2.0;
+            b1 = 1.0 - cosW0;
+            b2 = b0;
+            break;
+        case Type::HighPass:
+            b0 = (1.0 + cosW0) / 2.0;
+            b1 = -(1.0 + cosW0);
+            b2 = b0;
+            break;
+        case Type::BandPass:
+            b0 = alpha;
+            b1 = 0.0;
+            b2 = -alpha;
+            break;
+        }
+        return {
+            static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0),
+            static_cast<float>(2.0 * cosW0 / a0), static_cast<float>(-(1.0 - alpha) / a0),
+        };
+    }
+
+    // Coefficients of all stages back to back, for arm_biquad_cascade_df2T_init_f32.
+    template <size_t Stages>
+    constexpr std::array<float, 5 * Stages> Cascade(const std::array<Stage, Stages>& stages, const double sampleRateHz)
+    {
+        std::array<float, 5 * Stages> coefs{};
+        for (size_t s = 0; s < Stages; ++s)
+        {
+            const auto stage = Design(stages[s], sampleRateHz);
+            for (size_t i = 0; i < stage.size(); ++i)
+            {
+                coefs[5 * s + i] = stage[i];
+            }
+        }
+        return coefs;
+    }
+
+    // Stages of a Butterworth low- or high-pass of order 2 * Stages: same frequency, staggered Q.
+    template <size_t Stages>
+    constexpr std::array<Stage, Stages> Butterworth(const Type type, const double frequencyHz)
+    {
+        std::array<Stage, Stages> stages{};
+        for (size_t k = 0; k < Stages; ++k)
+        {
+            const double angle = (2.0 * k + 1.0) * ConstexprMath::Pi / (4.0 * Stages);
+            stages[k] = {type, frequencyHz, 1.0 / (2.0 * ConstexprMath::Cos(angle))};
+        }
+        return stages;
+    }
+
+    template <size_t Stages>
+    constexpr bool Valid(const std::array<Stage, Stages>& stages, const double sampleRateHz)
+    {
+        for (const auto& stage : stages)
+        {
+            if (stage.frequencyHz <= 0.0 || stage.frequencyHz >= sampleRateHz / 2.0 || stage.q <= 0.0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+
+namespace SignalProcessing::ConstexprMath
+{
+    /**
+     * Trigonometry usable in constant expressions (std::sin/cos are not constexpr in C++20), for
+     * filter coefficients and tables computed at compile time. Accurate to ~1e-12 after range
+     * reduction, far below float resolution.
+     */
+    inline constexpr double Pi = 3.14159265358979323846;
+
+    constexpr double Sin(double x)
+    {
+        // reduce to [-pi, pi]
+        const double turns = x / (2.0 * Pi);
+        x -= 2.0 * Pi * static_cast<double>(static_cast<long long>(turns >= 0 ? turns + 0.5 : turns - 0.5));
+
+        double term = x;
+        double sum = x;
+        for (size_t n = 1; n < 16; ++n)
+        {
+            term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double Cos(const double x)
+    {
+        return Sin(x + Pi / 2.0);
+    }
+
+    constexpr double Exp(double x)
+    {
+        // e^x = (e^(x / 2^k))^(2^k), with |x / 2^k| <= 0.5 for a short series
+        size_t halvings = 0;
+        while (x > 0.5 || x < -0.5)
+        {
+            x /= 2.0;
+            ++halvings;
+        }
+        double term = 1.0;
+        double sum = 1.0;
+        for (size_t n = 1; n < 16; ++n)
+        {
+            term *= x / static_cast<double>(n);
+            sum += term;
+        }
+        for (; halvings > 0; --halvings)
+        {
+            sum *= sum;
+        }
+        return sum;
+    }
+
+    // x^(1/n) for x >= 1, by bisection
+    constexpr double NthRoot(const double x, const size_t n)
+    {
+        double lo = 1.0;
+        double hi = x;
+        for (size_t i = 0; i < 100; ++i)
+        {
+            const double mid = (lo + hi) / 2.0;
+            double p = 1.0;
+            for (size_t k = 0; k < n; ++k)
+            {
+                p *= mid;
+            }
+            (p > x ? hi : lo) = mid;
+        }
+        return lo;
+    }
+
+    constexpr bool IsPowerOfTwo(const size_t n)
+    {
+        return n > 0 && (n & (n - 1)) == 0;
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <dsp/filtering_functions.h>
+
+#include "BeatBands.hpp"
+#include "ConstexprMath.hpp"
+#include "LpFilter.hpp"
+#include "SampleFormat.hpp"
+
+namespace SignalProcessing
+{
+    // Hamming windowed sinc, cut-off at 80 % of the decimated Nyquist frequency, unity DC gain
+    template <size_t NumTaps, size_t Factor>
+    constexpr std::array<float, NumTaps> WindowedSincLowPass()
+    {
+        using ConstexprMath::Cos;
+        using ConstexprMath::Pi;
+        using ConstexprMath::Sin;
+        constexpr double cutoff = 0.8 * 0.5 / Factor; // cycles per input sample
+        constexpr double centre = (NumTaps - 1) / 2.0;
+
+        std::array<double, NumTaps> taps{};
+        double sum = 0.0;
+        for (size_t n = 0; n < NumTaps; ++n)
+        {
+            const double t = static_cast<double>(n) - centre;
+            const double sinc = t == 0.0 ? 2.0 * cutoff : Sin(2.0 * Pi * cutoff * t) / (Pi * t);
+            const double window = 0.54 - 0.46 * Cos(2.0 * Pi * n / (NumTaps - 1));
+            taps[n] = sinc * window;
+            sum += taps[n];
+        }
+        std::array<float, NumTaps> normalised{};
+        for (size_t n = 0; n < NumTaps; ++n)
+        {
+            normalised[n] = static_cast<float>(taps[n] / sum);
+        }
+        return normalised;
+    }
+
+    /**
+     * Anti-alias low-pass and down-sampling by Factor in one polyphase FIR (arm_fir_decimate) for
+     * frames of FrameSize samples at InputRateHz: only every Factor-th output is computed, so the
+     * filter costs NumTaps MACs per output sample. Turns one ADC frame into one analysis hop at the
+     * decimated rate.
+     */
+    template <int InputRateHz, size_t FrameSize, size_t Factor>
+    class Decimator
+    {
+    public:
+        static constexpr size_t NumTaps = 8 * Factor;
+
+        static_assert(InputRateHz > 0 && Factor > 0, "invalid sample rate or decimation factor");
+        static_assert(FrameSize % Factor == 0, "frame must be a multiple of the decimation factor");
+
+        using Input = std::array<Constants::AudioSample, FrameSize>;
+        using Output = std::array<Constants::AudioSample, FrameSize / Factor>;
+
+        static constexpr int OutputRate_hz = InputRateHz / static_cast<int>(Factor);
+
+        void Initialize()
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            arm_fir_decimate_init_q15(&this->S, NumTaps, Factor, this->coefs_.data(), this->state_.data(), FrameSize);
+#else
+            arm_fir_decimate_init_f32(&this->S, NumTaps, Factor, this->coefs_.data(), this->state_.data(), FrameSize);
+#endif
+        }
+
+        void Process(const Input& input, Output& output) const
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            arm_fir_decimate_fast_q15(&this->S, input.data(), output.data(), FrameSize);
+#else
+            arm_fir_decimate_f32(&this->S, input.data(), output.data(), FrameSize);
+#endif
+        }
+
+    private:
+        static constexpr std::array<float, NumTaps> Taps = WindowedSincLowPass<NumTaps, Factor>();
+
+#if defined(CONFIG_APP_DSP_Q15)
+        // taps are below 1.0 (unity DC gain spread over NumTaps), so they convert without scaling
+        static constexpr std::array<q15_t, NumTaps> ToQ15(const std::array<float, NumTaps>& taps)
+        {
+            std::array<q15_t, NumTaps> q15{};
+            for (size_t n = 0; n < NumTaps; ++n)
+            {
+                const float scaled = taps[n] * 32768.0f;
+                q15[n] = static_cast<q15_t>(scaled >= 32767.0f ? 32767.0f : scaled + (scaled < 0 ? -0.5f : 0.5f));
+            }
+            return q15;
+        }
+
+        arm_fir_decimate_instance_q15 S{};
+        std::array<q15_t, NumTaps> coefs_ = ToQ15(Taps);
+        std::array<q15_t, NumTaps + FrameSize - 1> state_{};
+#else
+        arm_fir_decimate_instance_f32 S{};
+        std::array<float, NumTaps> coefs_ = Taps;
+        std::array<float, NumTaps + FrameSize - 1> state_{};
+#endif
+    };
+
+    /**
+     * First stage of the analysis chain: band-limits one ADC frame into one analysis hop. Any type
+     * with Input, Output, OutputRate_hz, Initialize() and Process(const Input&, Output&) can take
+     * its place; the detectors derive rate, frame and hop size from it.
+     */
+#if defined(CONFIG_APP_DSP_DECIMATION)
+    using AnalysisFrontEnd = Decimator<Constants::SampleRate_hz, Constants::SamplingFrameSize,
+                                       Constants::DecimationFactor>;
+#else
+    // Full rate: the low-pass must pass the hi-hat band; a 2nd order Butterworth at 4.9 kHz is
+    // down 0.3 dB at 4.8 kHz, where the default 2 kHz cut-off took 8 to 24 dB off the band.
+    inline constexpr int AnalysisCutoff_hz = 4900;
+    static_assert(BeatBands.back().hi_hz <= AnalysisCutoff_hz - 100.0f, "the front end cuts into the top beat band");
+    using AnalysisFrontEnd = LpFilter<Constants::SampleRate_hz, Constants::SamplingFrameSize, 1, AnalysisCutoff_hz>;
+#endif
+    static_assert(AnalysisFrontEnd::OutputRate_hz == Constants::AnalysisSampleRate_hz &&
+                  std::tuple_size_v<AnalysisFrontEnd::Output> == Constants::AnalysisHopSize,
+                  "the front end must turn one ADC frame into one analysis hop");
+}
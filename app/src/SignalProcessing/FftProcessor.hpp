@@ -5,35 +5,193 @@
 #pragma once
 
 #include "arm_math.h"
+#include "ConstexprMath.hpp"
+#include "SampleFormat.hpp"
 
 namespace SignalProcessing
 {
+    enum class FftWindow : uint8_t { Rectangular, Hann, Hamming };
+
+    /**
+     * Spectrum of FrameSize real samples at SampleRateHz; bin arithmetic and the window table are constexpr.
+     *
+     * The window is normalised to unity coherent gain, so a sinusoid shows the same bin magnitude
+     * with any window. Magnitude() and Power() only post-process the requested bins [firstBin, endBin);
+     * the FFT itself always covers the whole frame.
+     */
+    template <int SampleRateHz, size_t FrameSize, FftWindow Window = FftWindow::Hann>
     class FftProcessor
     {
+        static_assert(ConstexprMath::IsPowerOfTwo(FrameSize) && FrameSize >= 32 && FrameSize <= 4096,
+                      "CMSIS real FFTs support power of two lengths from 32 to 4096");
+        static_assert(SampleRateHz > 0, "invalid sample rate");
+
     public:
+        using Input = std::array<Constants::AudioSample, FrameSize>;
+        using Output = std::array<float, FrameSize / 2>;
+
+        static constexpr int SampleRate_hz = SampleRateHz;
+        static constexpr size_t Size = FrameSize;
+        static constexpr size_t BinCount = FrameSize / 2;
+        static constexpr float BinWidth_hz = static_cast<float>(SampleRateHz) / FrameSize;
+        // bins the output always zeroes: DC and the two highest
+        static constexpr size_t FirstUsableBin = 1;
+        static constexpr size_t LastUsableBin = BinCount - 3;
+
+        // bin containing hz
+        static constexpr size_t Bin(const float hz)
+        {
+            return static_cast<size_t>(hz / BinWidth_hz);
+        }
+
+        // nearest bin edge to hz, for exclusive upper band limits
+        static constexpr size_t BinEdge(const float hz)
+        {
+            return static_cast<size_t>(hz / BinWidth_hz + 0.5f);
+        }
+
         FftProcessor()
         {
         }
 
         int Initialize()
         {
-            return arm_rfft_fast_init_f32(&this->rFFT_, Constants::SamplingFrameSize);
+#if defined(CONFIG_APP_DSP_Q15)
+            return arm_rfft_init_q15(&this->rFFT_, FrameSize, 0, 1);
+#else
+            return arm_rfft_fast_init_f32(&this->rFFT_, FrameSize);
+#endif
         }
 
-        void Process(array<float, Constants::SamplingFrameSize>& input,
-                     array<float, Constants::SamplingFrameSize / 2>& output)
+        // |X(k)|; input is used as scratch and overwritten
+        void Magnitude(Input& input, Output& output, const size_t firstBin = 0, const size_t endBin = BinCount)
         {
-            arm_rfft_fast_f32(&this->rFFT_, input.data(), this->buffer.data(), 0);
-            arm_cmplx_mag_f32(this->buffer.data(), output.data(), output.size());
+            Transform(input);
+            const size_t count = endBin - firstBin;
+#if defined(CONFIG_APP_DSP_Q15)
+            arm_cmplx_mag_q15(&this->buffer[2 * firstBin], &this->result_[firstBin], count);
 
-            // smooth outliers in extrema and DC
-            output[0] = 0;
-            output[Constants::SamplingFrameSize / 2 - 1] = 0;
-            output[Constants::SamplingFrameSize / 2 - 2] = 0;
+            // rfft_q15 scales by 1/(N/2), cmplx_mag_q15 by another 1/2: undo both so that the
+            // spectrum has the same unit as the float path
+            arm_q15_to_float(&this->result_[firstBin], &output[firstBin], count);
+            arm_scale_f32(&output[firstBin], static_cast<float>(FrameSize) * WindowCompensation, &output[firstBin],
+                          count);
+#else
+            arm_cmplx_mag_f32(&this->buffer[2 * firstBin], &output[firstBin], count);
+#endif
+            BlankEdges(output, firstBin, endBin);
+        }
+
+        // |X(k)|^2, no square root per bin; input is used as scratch and overwritten
+        void Power(Input& input, Output& output, const size_t firstBin = 0, const size_t endBin = BinCount)
+        {
+            Transform(input);
+            const size_t count = endBin - firstBin;
+#if defined(CONFIG_APP_DSP_Q15)
+            // 3.13 result of a spectrum scaled by 1/(N/2): N^2 restores the float unit. Bins below
+            // ~1/N of full scale underflow to zero.
+            arm_cmplx_mag_squared_q15(&this->buffer[2 * firstBin], &this->result_[firstBin], count);
+            arm_q15_to_float(&this->result_[firstBin], &output[firstBin], count);
+            arm_scale_f32(&output[firstBin],
+                          static_cast<float>(FrameSize) * FrameSize * WindowCompensation * WindowCompensation,
+                          &output[firstBin], count);
+#else
+            arm_cmplx_mag_squared_f32(&this->buffer[2 * firstBin], &output[firstBin], count);
+#endif
+            BlankEdges(output, firstBin, endBin);
         }
 
     private:
+        static constexpr std::array<double, FrameSize> WindowShape()
+        {
+            std::array<double, FrameSize> w{};
+            for (size_t n = 0; n < FrameSize; ++n)
+            {
+                // periodic windows, as used for spectral analysis
+                const double c = ConstexprMath::Cos(2.0 * ConstexprMath::Pi * n / FrameSize);
+                w[n] = Window == FftWindow::Hann ? 0.5 - 0.5 * c : Window == FftWindow::Hamming ? 0.54 - 0.46 * c : 1.0;
+            }
+            return w;
+        }
+
+        static constexpr double CoherentGain()
+        {
+            double sum = 0.0;
+            for (const auto w : WindowShape())
+            {
+                sum += w;
+            }
+            return sum / FrameSize;
+        }
+
+#if defined(CONFIG_APP_DSP_Q15)
+        // Q15 cannot hold the normalised window (peak 2): it is applied unnormalised and compensated when scaling
+        static constexpr float WindowCompensation = static_cast<float>(1.0 / CoherentGain());
+
+        static constexpr std::array<q15_t, FrameSize> WindowTable()
+        {
+            std::array<q15_t, FrameSize> table{};
+            const auto shape = WindowShape();
+            for (size_t n = 0; n < FrameSize; ++n)
+            {
+                const double scaled = shape[n] * 32768.0;
+                table[n] = static_cast<q15_t>(scaled >= 32767.0 ? 32767.0 : scaled + 0.5);
+            }
+            return table;
+        }
+#else
+        static constexpr std::array<float, FrameSize> WindowTable()
+        {
+            std::array<float, FrameSize> table{};
+            const auto shape = WindowShape();
+            for (size_t n = 0; n < FrameSize; ++n)
+            {
+                table[n] = static_cast<float>(shape[n] / CoherentGain());
+            }
+            return table;
+        }
+#endif
+
+        static constexpr auto window_ = WindowTable();
+
+        void Transform(Input& input)
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            if constexpr (Window != FftWindow::Rectangular)
+            {
+                arm_mult_q15(input.data(), window_.data(), input.data(), FrameSize);
+            }
+            arm_rfft_q15(&this->rFFT_, input.data(), this->buffer.data());
+#else
+            if constexpr (Window != FftWindow::Rectangular)
+            {
+                arm_mult_f32(input.data(), window_.data(), input.data(), FrameSize);
+            }
+            arm_rfft_fast_f32(&this->rFFT_, input.data(), this->buffer.data(), 0);
+#endif
+        }
+
+        // smooth outliers in extrema and DC
+        static void BlankEdges(Output& output, const size_t firstBin, const size_t endBin)
+        {
+            for (const size_t bin : {size_t{0}, BinCount - 1, BinCount - 2})
+            {
+                if (bin >= firstBin && bin < endBin)
+                {
+                    output[bin] = 0;
+                }
+            }
+        }
+
+#if defined(CONFIG_APP_DSP_Q15)
+        arm_rfft_instance_q15 rFFT_{};
+        array<q15_t, FrameSize * 2> buffer{};
+        array<q15_t, BinCount> result_{};
+#else
         arm_rfft_fast_instance_f32 rFFT_{};
-        array<float, Constants::SamplingFrameSize> buffer{};
+        array<float, FrameSize> buffer{};
+#endif
     };
+
+    using AnalysisFft = FftProcessor<Constants::AnalysisSampleRate_hz, Constants::AnalysisWindowSize>;
 }
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "ConstexprMath.hpp"
+
+namespace SignalProcessing
+{
+    /**
+     * Reduces an Fft spectrum to BandCount log-spaced bands from MinHz to the highest usable bin,
+     * as 8 bit levels for animations. The bin -> band table is built at compile time; every band
+     * gets at least one bin, so the lowest bands may be narrower than log spacing would make them.
+     *
+     * Level 255 is a full-scale sinusoid (amplitude 1.0) in the band, 0 is DynamicRange_dB below.
+     */
+    template <typename Fft, size_t BandCount>
+    class LogSpectrum
+    {
+    public:
+        using Levels = std::array<uint8_t, BandCount>;
+
+        static constexpr float MinHz = 30.0f;
+        static constexpr float DynamicRange_dB = 72.0f; // ~12 bit ADC
+        static constexpr size_t FirstBin = Fft::Bin(MinHz) > Fft::FirstUsableBin ? Fft::Bin(MinHz)
+                                                                                   : Fft::FirstUsableBin;
+        static constexpr size_t EndBin = Fft::LastUsableBin + 1;
+
+        static_assert(BandCount > 0 && BandCount <= 0xFF, "band index must fit into the table");
+        static_assert(EndBin - FirstBin >= BandCount, "FFT too short for this many bands");
+
+        // spectrum holds |X(k)|^2 if power, else |X(k)|; only bins [FirstBin, EndBin) are read
+        static void Reduce(const typename Fft::Output& spectrum, const bool power, Levels& levels)
+        {
+            std::array<float, BandCount> sums{};
+            for (size_t bin = FirstBin; bin < EndBin; ++bin)
+            {
+                const float value = spectrum[bin];
+                sums[BandOfBin[bin - FirstBin]] += power ? value : value * value;
+            }
+
+            for (size_t band = 0; band < BandCount; ++band)
+            {
+                const float mean = sums[band] / static_cast<float>(BinsPerBand[band]);
+                const float dB = mean > 0.0f ? 10.0f * std::log10(mean / ReferencePower) : -DynamicRange_dB;
+                const float level = (dB + DynamicRange_dB) * (255.0f / DynamicRange_dB);
+                levels[band] = static_cast<uint8_t>(level <= 0.0f ? 0.0f : level >= 255.0f ? 255.0f : level);
+            }
+        }
+
+    private:
+        // a unit sinusoid peaks at N/2 in an FFT whose window has unity coherent gain
+        static constexpr float ReferencePower = static_cast<float>(Fft::Size / 2) * static_cast<float>(Fft::Size / 2);
+
+        static constexpr std::array<size_t, BandCount + 1> Edges()
+        {
+            const double ratio = ConstexprMath::NthRoot(static_cast<double>(EndBin) / FirstBin, BandCount);
+            std::array<size_t, BandCount + 1> edges{};
+            edges[0] = FirstBin;
+            double edge = FirstBin;
+            for (size_t band = 1; band < BandCount; ++band)
+            {
+                edge *= ratio;
+                size_t bin = static_cast<size_t>(edge + 0.5);
+                bin = bin > edges[band - 1] ? bin : edges[band - 1] + 1;
+                const size_t latest = EndBin - (BandCount - band); // leave a bin for every band above
+                edges[band] = bin < latest ? bin : latest;
+            }
+            edges[BandCount] = EndBin;
+            return edges;
+        }
+
+        static constexpr std::array<uint8_t, EndBin - FirstBin> MakeBandOfBin()
+        {
+            const auto edges = Edges();
+            std::array<uint8_t, EndBin - FirstBin> table{};
+            for (size_t band = 0; band < BandCount; ++band)
+            {
+                for (size_t bin = edges[band]; bin < edges[band + 1]; ++bin)
+                {
+                    table[bin - FirstBin] = static_cast<uint8_t>(band);
+                }
+            }
+            return table;
+        }
+
+        static constexpr std::array<uint16_t, BandCount> MakeBinsPerBand()
+        {
+            const auto edges = Edges();
+            std::array<uint16_t, BandCount> counts{};
+            for (size_t band = 0; band < BandCount; ++band)
+            {
+                counts[band] = static_cast<uint16_t>(edges[band + 1] - edges[band]);
+            }
+            return counts;
+        }
+
+        static constexpr auto BandOfBin = MakeBandOfBin();
+        static constexpr auto BinsPerBand = MakeBinsPerBand();
+    };
+}
@@ -1,34 +1,113 @@
 #pragma once
 #include <dsp/filtering_functions.h>
 
+#include "BiquadDesign.hpp"
+#include "SampleFormat.hpp"
+
 namespace SignalProcessing
 {
+    // Butterworth low-pass of order 2 * Stages for FrameSize samples at SampleRateHz, as a biquad
+    // cascade whose coefficients are designed at compile time.
+    template <int SampleRateHz, size_t FrameSize, size_t Stages = 1, int CutoffHz = 2000>
     class LpFilter
     {
         public:
 
+        static_assert(SampleRateHz > 0 && FrameSize > 0 && Stages > 0, "invalid sample rate, frame size or order");
+
+        using Frame = std::array<Constants::AudioSample, FrameSize>;
+        // as an analysis front end: filters without changing rate or frame size
+        using Input = Frame;
+        using Output = Frame;
+
+        static constexpr int OutputRate_hz = SampleRateHz;
+
         LpFilter(): irrState()
         {
         }
 
         void Initialize()
         {
-            arm_biquad_cascade_df2T_init_f32(&S, numStageIir, this->coefs.data(), this->irrState.data());
+#if defined(CONFIG_APP_DSP_Q15)
+            arm_biquad_cascade_df1_init_q15(&S, Stages, this->coefs.data(), this->irrState.data(), postShift);
+#else
+            arm_biquad_cascade_df2T_init_f32(&S, Stages, this->coefs.data(), this->irrState.data());
+#endif
         }
 
-        void Process(const std::array<float, Constants::SamplingFrameSize>& input, std::array<float, Constants::SamplingFrameSize>& output) const
+        void Process(const Frame& input, Frame& output) const
         {
-            arm_biquad_cascade_df2T_f32(&S, input.data(), output.data(), Constants::SamplingFrameSize);
+#if defined(CONFIG_APP_DSP_Q15)
+            arm_biquad_cascade_df1_q15(&S, input.data(), output.data(), FrameSize);
+#else
+            arm_biquad_cascade_df2T_f32(&S, input.data(), output.data(), FrameSize);
+#endif
+        }
+
+        // CMSIS biquads may run in place
+        void Process(Frame& frame) const
+        {
+            Process(frame, frame);
         }
 
         private:
 
-        static constexpr size_t numStageIir = 1;
+        static constexpr auto stages = BiquadDesign::Butterworth<Stages>(BiquadDesign::Type::LowPass, CutoffHz);
+        static_assert(BiquadDesign::Valid(stages, SampleRateHz), "cut-off must be below the Nyquist frequency");
+
         static constexpr size_t numStageCoef = 5;
+        static constexpr std::array<float, Stages * numStageCoef> floatCoefs =
+            BiquadDesign::Cascade(stages, SampleRateHz); //b10, b11, b12, a11, a12, b20, ...
+
+#if defined(CONFIG_APP_DSP_Q15)
+        // smallest shift that brings every coefficient below 1.0; the filter shifts its output back
+        static constexpr int8_t PostShift()
+        {
+            float largest = 0.0f;
+            for (const auto coef : floatCoefs)
+            {
+                largest = coef < 0.0f ? (-coef > largest ? -coef : largest) : (coef > largest ? coef : largest);
+            }
+            int8_t shift = 0;
+            while (largest >= 1.0f)
+            {
+                largest /= 2.0f;
+                ++shift;
+            }
+            return shift;
+        }
+
+        static constexpr int8_t postShift = PostShift();
+
+        static constexpr q15_t ToQ15(const float value)
+        {
+            const float scaled = value / static_cast<float>(1 << postShift) * 32768.0f;
+            return static_cast<q15_t>(scaled >= 32767.0f ? 32767.0f : scaled);
+        }
+
+        static constexpr std::array<q15_t, Stages * 6> Q15Coefs()
+        {
+            std::array<q15_t, Stages * 6> q15{};
+            for (size_t s = 0; s < Stages; ++s)
+            {
+                const auto* c = &floatCoefs[s * numStageCoef];
+                q15[s * 6 + 0] = ToQ15(c[0]);
+                q15[s * 6 + 1] = 0;
+                q15[s * 6 + 2] = ToQ15(c[1]);
+                q15[s * 6 + 3] = ToQ15(c[2]);
+                q15[s * 6 + 4] = ToQ15(c[3]);
+                q15[s * 6 + 5] = ToQ15(c[4]);
+            }
+            return q15;
+        }
 
+        arm_biquad_casd_df1_inst_q15 S{};
+        std::array<q15_t, Stages * 4> irrState;
+        std::array<q15_t, Stages * 6> coefs = Q15Coefs(); //b10, 0, b11, b12, a11, a12 per stage
+#else
         arm_biquad_cascade_df2T_instance_f32 S{};
-        static constexpr size_t numOrderIir = numStageIir * 2;
-        std::array<float, numOrderIir> irrState;
-        std::array<float, numStageIir * numStageCoef> coefs {0.19952362386506783, 0.39904724773013567, 0.19952362386506783, -0.35691870886351296, 0.15501320432378424}; //b10, b11, b12, a11, a12
+        std::array<float, Stages * 2> irrState;
+        std::array<float, Stages * numStageCoef> coefs = floatCoefs;
+#endif
     };
 };
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace SignalProcessing
+{
+    /**
+     * Streaming sample rate converter for any ratio of two integer rates: windowed sinc
+     * interpolation (Blackman, 2 * HalfTaps taps), with the cut-off moved below the output's
+     * Nyquist frequency when downsampling. The default length is meant for 44.1/48 kHz material
+     * at 10 kHz out. The kernel is tabulated at Phases fractional positions and interpolated
+     * linearly between them. The output position advances in exact integer steps, so output
+     * sample n is input time n / outputRate however long the stream.
+     *
+     * Pull-driven, no output buffering: Push() input samplings while NeedsInput(), then Pull() one
+     * output sampling. Input before the first sample counts as silence.
+     */
+    template <size_t Channels, size_t HalfTaps = 48, size_t Phases = 32>
+    class Resampler
+    {
+    public:
+        using Sampling = std::array<float, Channels>;
+
+        Resampler(const int inputRate_hz, const int outputRate_hz)
+            : inputRate_(static_cast<uint32_t>(inputRate_hz)), outputRate_(static_cast<uint32_t>(outputRate_hz))
+        {
+            const double cutoff = inputRate_hz > outputRate_hz
+                                      ? Rolloff * outputRate_hz / static_cast<double>(inputRate_hz)
+                                      : 1.0;
+            for (size_t p = 0; p <= Phases; ++p)
+            {
+                const double frac = static_cast<double>(p) / Phases;
+                double sum = 0.0;
+                std::array<double, Taps> h{};
+                for (size_t k = 0; k < Taps; ++k)
+                {
+                    // input position of tap k relative to the output position
+                    const double d = static_cast<double>(k) - (HalfTaps - 1) - frac;
+                    h[k] = cutoff * Sinc(cutoff * d) * Blackman(d);
+                    sum += h[k];
+                }
+                // unity gain at DC in every phase
+                for (size_t k = 0; k < Taps; ++k)
+                {
+                    this->kernel_[p][k] = static_cast<float>(h[k] / sum);
+                }
+            }
+        }
+
+        bool NeedsInput() const
+        {
+            return this->pushed_ <= this->position_ + HalfTaps;
+        }
+
+        void Push(const Sampling& sampling)
+        {
+            // mirrored, so the last Taps samplings are always contiguous from write_
+            this->history_[this->write_] = sampling;
+            this->history_[this->write_ + Taps] = sampling;
+            this->write_ = (this->write_ + 1) % Taps;
+            ++this->pushed_;
+        }
+
+        // only once NeedsInput() is false
+        Sampling Pull()
+        {
+            const float phase = static_cast<float>(this->remainder_) * Phases / static_cast<float>(this->outputRate_);
+            const auto p = static_cast<size_t>(phase);
+            const float t = phase - static_cast<float>(p);
+            const auto& a = this->kernel_[p];
+            const auto& b = this->kernel_[p + 1];
+            const Sampling* window = &this->history_[this->write_];
+
+            Sampling out{};
+            for (size_t k = 0; k < Taps; ++k)
+            {
+                const float h = a[k] + t * (b[k] - a[k]);
+                for (size_t c = 0; c < Channels; ++c)
+                {
+                    out[c] += h * window[k][c];
+                }
+            }
+
+            this->remainder_ += this->inputRate_;
+            this->position_ += this->remainder_ / this->outputRate_;
+            this->remainder_ %= this->outputRate_;
+            return out;
+        }
+
+    private:
+        static constexpr size_t Taps = 2 * HalfTaps;
+        // leaves the transition band of the short kernel below the output's Nyquist frequency
+        static constexpr double Rolloff = 0.9;
+        static constexpr double Pi = 3.14159265358979323846;
+
+        static double Sinc(const double x)
+        {
+            return x == 0.0 ? 1.0 : std::sin(Pi * x) / (Pi * x);
+        }
+
+        static double Blackman(const double d)
+        {
+            const double x = d / HalfTaps;
+            return std::fabs(x) >= 1.0 ? 0.0 : 0.42 + 0.5 * std::cos(Pi * x) + 0.08 * std::cos(2.0 * Pi * x);
+        }
+
+        const uint32_t inputRate_;
+        const uint32_t outputRate_;
+        std::array<std::array<float, Taps>, Phases + 1> kernel_{};
+        std::array<Sampling, 2 * Taps> history_{};
+        size_t write_ = 0;
+        uint64_t pushed_ = 0;
+        // input index at or before the next output sampling, plus remainder_ / outputRate_
+        uint64_t position_ = 0;
+        uint32_t remainder_ = 0;
+    };
+}
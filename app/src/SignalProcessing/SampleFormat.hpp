@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include "arm_math.h"
+
+namespace SignalProcessing
+{
+    /**
+     * Sample frame as produced by the ADC and consumed by the DSP chain.
+     * With CONFIG_APP_DSP_Q15 samples are Q15 (full scale = 1.0), otherwise float volts.
+     */
+    using SampleFrame = std::array<Constants::AudioSample, Constants::SamplingFrameSize>;
+    using ChannelFrames = std::array<SampleFrame, Constants::AudioChannelCount>;
+
+    // Average of all channels; a single channel is returned as is without copying.
+    inline const SampleFrame& Downmix(const ChannelFrames& channels, SampleFrame& mono)
+    {
+        if constexpr (Constants::AudioChannelCount == 1)
+        {
+            return channels[0];
+        }
+        for (size_t i = 0; i < mono.size(); ++i)
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            int32_t sum = 0;
+#else
+            float sum = 0;
+#endif
+            for (const auto& channel : channels)
+            {
+                sum += channel[i];
+            }
+            mono[i] = static_cast<Constants::AudioSample>(sum / static_cast<int>(Constants::AudioChannelCount));
+        }
+        return mono;
+    }
+
+    // RMS and absolute peak of a frame, in the unit of the float path (volts / full scale)
+    template <size_t N>
+    void FrameLevels(const std::array<Constants::AudioSample, N>& samples, float& rms, float& peak)
+    {
+#if defined(CONFIG_APP_DSP_Q15)
+        q15_t rmsQ15 = 0;
+        q15_t peakQ15 = 0;
+        uint32_t index = 0;
+        arm_rms_q15(samples.data(), samples.size(), &rmsQ15);
+        arm_absmax_q15(samples.data(), samples.size(), &peakQ15, &index);
+        rms = static_cast<float>(rmsQ15) / 32768.0f;
+        peak = static_cast<float>(peakQ15) / 32768.0f;
+#else
+        uint32_t index = 0;
+        arm_rms_f32(samples.data(), samples.size(), &rms);
+        arm_absmax_f32(samples.data(), samples.size(), &peak, &index);
+#endif
+    }
+}
@@ -4,8 +4,16 @@
 
 #pragma once
 
+#include "SampleFormat.hpp"
+
 namespace SignalProcessing
 {
+    // bit b set: beat in band b (see BeatBands), 0: no beat
+    using BeatMask = uint8_t;
+    using SpectrumLevels = std::array<uint8_t, Constants::SpectrumBandCount>;
+
+    // an engine for frames of type Frame; the app's engines take SampleFrame
+    template <typename Frame = SampleFrame>
     class SignalProcessingBase
     {
     protected:
@@ -13,6 +21,10 @@ namespace SignalProcessing
 
     public:
         virtual int Initialize() = 0;
-        virtual bool Process(array<float, Constants::SamplingFrameSize>& samples) = 0;
+        virtual BeatMask Process(const Frame& samples) = 0;
+        // onset strength of the kick band in the last processed hop (>= 0), input of the TempoTracker
+        virtual float OnsetStrength() const = 0;
+        // log-spaced band levels of the last processed hop (needs CONFIG_APP_SPECTRUM_EVENTS for the full range)
+        virtual void GetSpectrum(SpectrumLevels& levels) const = 0;
     };
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+namespace SignalProcessing
+{
+    /**
+     * Analysis window over the most recent WindowSize samples, advanced one hop at a time.
+     * Hops are written in place (e.g. as filter output), so appending costs no copy.
+     */
+    template <typename T, size_t WindowSize, size_t HopSize>
+    class SlidingWindow
+    {
+        static_assert(HopSize > 0 && WindowSize % HopSize == 0, "window must be a multiple of the hop size");
+
+    public:
+        using Hop = std::array<T, HopSize>;
+        using Window = std::array<T, WindowSize>;
+
+        // Storage for the next hop; it becomes part of the window with Advance().
+        Hop& Next()
+        {
+            return hops_[next_];
+        }
+
+        void Advance()
+        {
+            next_ = (next_ + 1) % HopCount;
+        }
+
+        // Copy of the window, oldest sample first.
+        void CopyTo(Window& out) const
+        {
+            auto dst = out.begin();
+            for (size_t i = 0; i < HopCount; ++i)
+            {
+                const auto& hop = hops_[(next_ + i) % HopCount];
+                dst = std::copy(hop.begin(), hop.end(), dst);
+            }
+        }
+
+    private:
+        static constexpr size_t HopCount = WindowSize / HopSize;
+
+        std::array<Hop, HopCount> hops_{};
+        size_t next_{0};
+    };
+}
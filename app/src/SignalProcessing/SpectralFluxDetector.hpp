@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+
+#include "BeatBands.hpp"
+#include "Decimator.hpp"
+#include "FftProcessor.hpp"
+#include "LogSpectrum.hpp"
+#include "SignalProcessingBase.hpp"
+#include "SlidingWindow.hpp"
+#include "Utils/StreamingStats.hpp"
+
+namespace SignalProcessing
+{
+    /**
+     * Onset detector on half-wave rectified spectral flux, per BeatBands band:
+     *   flux(t) = sum over the band's bins of max(0, |X_t(k)| - |X_t-1(k)|)
+     * An onset is a local maximum of the flux that exceeds the running median of the flux
+     * (Utils::QuantileEstimator) times FluxMultiplier plus FluxOffset. Only energy increases count, so sustained bass does not
+     * keep triggering, while short transients do.
+     *
+     * The FFT writes alternately into one of two spectra, so the previous spectrum is never copied.
+     * Peak picking needs the following hop, so onsets are reported one hop (12.8 ms) late.
+     *
+     * Templated like BeatDetector on the front end and the FFT window.
+     */
+    template <typename FrontEnd, size_t WindowSize>
+    class SpectralFluxDetector final : public SignalProcessingBase<typename FrontEnd::Input>
+    {
+    public:
+        using Frame = typename FrontEnd::Input;
+        static constexpr int SampleRate_hz = FrontEnd::OutputRate_hz;
+        static constexpr size_t HopSize = std::tuple_size_v<typename FrontEnd::Output>;
+        using Fft = FftProcessor<SampleRate_hz, WindowSize>;
+
+        explicit SpectralFluxDetector(Fft& fftProcessor, FrontEnd& filter)
+            : filter_(filter), fftProcessor_(fftProcessor)
+        {
+        }
+
+        int Initialize() override
+        {
+            this->filter_.Initialize();
+            return this->fftProcessor_.Initialize();
+        }
+
+        BeatMask Process(const Frame& samples) override
+        {
+            this->filter_.Process(samples, this->window_.Next());
+            this->window_.Advance();
+            this->window_.CopyTo(this->fftIn_);
+
+            this->current_ ^= 1;
+            const auto& spectrum = this->spectra_[this->current_];
+            const auto& previous = this->spectra_[this->current_ ^ 1];
+            this->fftProcessor_.Magnitude(this->fftIn_, this->spectra_[this->current_], FirstFftBin, EndFftBin);
+
+            BeatMask onsets = 0;
+            for (size_t b = 0; b < BeatBands.size(); ++b)
+            {
+                float flux = 0.0f;
+                for (size_t i = Bins[b].lo; i < Bins[b].hi; ++i)
+                {
+                    const float rise = spectrum[i] - previous[i];
+                    flux += rise > 0.0f && !isnan(rise) ? rise : 0.0f;
+                }
+                flux /= static_cast<float>(Bins[b].hi - Bins[b].lo);
+                if (b == 0)
+                {
+                    this->onset_ = flux;
+                }
+                onsets |= PickPeak(this->bands_[b], Bins[b].refractoryHops, flux) ? BIT(b) : 0;
+            }
+            return onsets;
+        }
+
+        float OnsetStrength() const override
+        {
+            return this->onset_;
+        }
+
+        void GetSpectrum(SpectrumLevels& levels) const override
+        {
+            Spectrum::Reduce(this->spectra_[this->current_], false, levels);
+        }
+
+    private:
+        // step of the median estimate: it follows the flux over ~10 hops (~130 ms)
+        static constexpr float MedianRate = 0.1f;
+        static constexpr float FluxMultiplier = 1.5f;
+        static constexpr float FluxOffset = 0.005f;
+
+        static constexpr auto Bins = MakeBandBins<Fft, HopSize>();
+        static_assert(BandBinsValid<Fft>(Bins), "a beat band falls outside the usable FFT bins");
+
+        using Spectrum = LogSpectrum<Fft, Constants::SpectrumBandCount>;
+        static constexpr bool FullSpectrum = IS_ENABLED(CONFIG_APP_SPECTRUM_EVENTS);
+        static constexpr size_t FirstFftBin = FullSpectrum ? std::min(Spectrum::FirstBin, Bins.front().lo) : Bins.front().lo;
+        static constexpr size_t EndFftBin = FullSpectrum ? std::max(Spectrum::EndBin, Bins.back().hi) : Bins.back().hi;
+
+        struct Band
+        {
+            uint32_t holdoff = 0;
+            Utils::QuantileEstimator median{0.5f, MedianRate};
+            float last = 0.0f; // flux of the previous hop, the peak candidate
+            float beforeLast = 0.0f;
+        };
+
+        // Reports the previous hop if it was a local flux maximum above the adaptive threshold.
+        static bool PickPeak(Band& band, const uint32_t refractoryHops, const float flux)
+        {
+            const float threshold = band.median.Value() * FluxMultiplier + FluxOffset;
+
+            const float candidate = band.last;
+            const bool peak = candidate > threshold && candidate >= band.beforeLast && candidate > flux;
+
+            band.median.Add(flux);
+            band.beforeLast = band.last;
+            band.last = flux;
+
+            if (band.holdoff > 0)
+            {
+                --band.holdoff;
+                return false;
+            }
+            if (peak)
+            {
+                band.holdoff = refractoryHops;
+            }
+            return peak;
+        }
+
+        std::array<Band, BeatBands.size()> bands_{};
+        SlidingWindow<Constants::AudioSample, WindowSize, HopSize> window_{};
+        typename Fft::Input fftIn_{};
+        std::array<typename Fft::Output, 2> spectra_{};
+        uint8_t current_ = 0;
+        float onset_ = 0.0f;
+        FrontEnd& filter_;
+        Fft& fftProcessor_;
+    };
+
+    using AnalysisSpectralFluxDetector = SpectralFluxDetector<AnalysisFrontEnd, Constants::AnalysisWindowSize>;
+}
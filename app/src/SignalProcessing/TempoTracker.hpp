@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <dsp/basic_math_functions.h>
+#include <dsp/statistics_functions.h>
+
+#include "Utils/TimeStamp.hpp"
+
+namespace SignalProcessing
+{
+    /**
+     * Tempo and beat phase from the per-hop onset strength of the beat engine.
+     *
+     * Every UpdateHops hops the autocorrelation of the last HistoryHops onset values (mean removed)
+     * is evaluated for all lags between MaxBpm and MinBpm, weighted towards ~120 BPM to avoid
+     * locking onto half or double tempo. The best lag (refined by parabolic interpolation) is the
+     * beat period; the phase is the offset whose comb over the last CombBeats periods collects the
+     * most onset energy. The history is stored twice in a row, so the window is always contiguous.
+     */
+    class TempoTracker
+    {
+    public:
+        struct Estimate
+        {
+            float bpm = 0.0f;
+            float confidence = 0.0f; // 0..1, normalised autocorrelation at the beat period
+            uint64_t period_ns = 0;
+            Utils::TimeStamp::Timestamp nextBeat{}; // capture time of the predicted next beat
+        };
+
+        static constexpr uint32_t MinBpm = 60;
+        static constexpr uint32_t MaxBpm = 180;
+
+        // Returns true when a new estimate is available (every UpdateHops hops).
+        bool Update(const float onset, const Utils::TimeStamp::Timestamp& captured)
+        {
+            this->history_[this->write_] = onset;
+            this->history_[this->write_ + HistoryHops] = onset;
+            this->write_ = (this->write_ + 1) % HistoryHops;
+            this->lastCapture_ = captured;
+            if (this->filled_ < HistoryHops)
+            {
+                ++this->filled_;
+            }
+
+            if (++this->sinceUpdate_ < UpdateHops || this->filled_ < HistoryHops)
+            {
+                return false;
+            }
+            this->sinceUpdate_ = 0;
+            UpdateEstimate();
+            return true;
+        }
+
+        const Estimate& Get() const
+        {
+            return this->estimate_;
+        }
+
+    private:
+        static constexpr uint64_t HopPeriod_ns =
+            static_cast<uint64_t>(Constants::SamplingFrameSize) * Constants::SamplingInterval_us * 1000ULL;
+        static constexpr float HopsPerMinute = 60e9f / HopPeriod_ns;
+        static constexpr size_t HistoryHops = 6'000'000'000ULL / HopPeriod_ns; // ~6 s
+        static constexpr size_t MinLag = static_cast<size_t>(HopsPerMinute / MaxBpm);
+        static constexpr size_t MaxLag = static_cast<size_t>(HopsPerMinute / MinBpm) + 1;
+        static constexpr size_t UpdateHops = 8; // ~100 ms
+        static constexpr size_t CombBeats = 4;
+        static_assert(MaxLag * CombBeats < HistoryHops, "history too short for the slowest tempo");
+
+        void UpdateEstimate()
+        {
+            // oldest sample first; the mean would correlate at every lag
+            float mean = 0.0f;
+            arm_mean_f32(&this->history_[this->write_], HistoryHops, &mean);
+            arm_offset_f32(&this->history_[this->write_], -mean, this->centred_.data(), HistoryHops);
+            const float* window = this->centred_.data();
+
+            float energy = 0.0f;
+            arm_dot_prod_f32(window, window, HistoryHops, &energy);
+            if (energy <= 0.0f)
+            {
+                this->estimate_ = {};
+                return;
+            }
+
+            std::array<float, MaxLag + 2> acf{};
+            size_t bestLag = MinLag;
+            float best = -1.0f;
+            for (size_t lag = MinLag - 1; lag <= MaxLag + 1; ++lag)
+            {
+                arm_dot_prod_f32(window, window + lag, HistoryHops - lag, &acf[lag]);
+                acf[lag] /= static_cast<float>(HistoryHops - lag);
+                if (lag < MinLag || lag > MaxLag)
+                {
+                    continue;
+                }
+                // log-normal tempo prior centred on 120 BPM
+                const float octaves = std::log2(HopsPerMinute / lag / 120.0f);
+                const float weighted = acf[lag] * std::exp(-0.5f * octaves * octaves);
+                if (weighted > best)
+                {
+                    best = weighted;
+                    bestLag = lag;
+                }
+            }
+
+            // parabolic interpolation around the peak
+            const float l = acf[bestLag - 1];
+            const float c = acf[bestLag];
+            const float r = acf[bestLag + 1];
+            const float denom = l - 2.0f * c + r;
+            const float offset = denom != 0.0f ? 0.5f * (l - r) / denom : 0.0f;
+            const float period = static_cast<float>(bestLag) + (std::fabs(offset) < 1.0f ? offset : 0.0f);
+
+            // phase: which hop within the last period starts the strongest comb
+            const float* newest = &this->history_[this->write_ + HistoryHops - 1];
+            size_t bestPhase = 0;
+            float bestComb = -1.0f;
+            for (size_t phase = 0; phase < bestLag; ++phase)
+            {
+                float comb = 0.0f;
+                for (size_t k = 0; k < CombBeats; ++k)
+                {
+                    comb += *(newest - phase - static_cast<size_t>(k * period + 0.5f));
+                }
+                if (comb > bestComb)
+                {
+                    bestComb = comb;
+                    bestPhase = phase;
+                }
+            }
+
+            auto& e = this->estimate_;
+            e.bpm = HopsPerMinute / period;
+            e.confidence = std::fmax(0.0f, std::fmin(1.0f, c * HistoryHops / energy));
+            e.period_ns = static_cast<uint64_t>(period * HopPeriod_ns);
+            // the last beat was 'bestPhase' hops before the newest hop
+            e.nextBeat.nSec = this->lastCapture_.nSec - bestPhase * HopPeriod_ns + e.period_ns;
+        }
+
+        std::array<float, 2 * HistoryHops> history_{};
+        std::array<float, HistoryHops> centred_{};
+        size_t write_ = 0;
+        size_t filled_ = 0;
+        size_t sinceUpdate_ = 0;
+        Utils::TimeStamp::Timestamp lastCapture_{};
+        Estimate estimate_{};
+    };
+}
@@ -5,6 +5,8 @@
 #pragma once
 #include <functional>
 
+#include <zephyr/drivers/gpio.h>
+
 namespace UtilsButton
 {
   enum class ButtonState : uint8_t { Pressed, ReleasedShort, ReleasedLong };
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <type_traits>
+
 namespace Detail
 {
     template <typename... Ts>
@@ -13,4 +16,14 @@ namespace Detail
         ((m = (m < sizeof(Ts)) ? sizeof(Ts) : m), ...);
         return m;
     }
+
+    // position of T in Ts; sizeof...(Ts) if absent
+    template <typename T, typename... Ts>
+    constexpr std::size_t index_of() noexcept
+    {
+        std::size_t index = 0;
+        bool found = false;
+        ((found = found || std::is_same_v<T, Ts>, index += found ? 0U : 1U), ...);
+        return index;
+    }
 }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Utils
+{
+    /**
+     * Running min/avg/max over a series of durations (ns).
+     * Cheap enough to be updated from the sampling path.
+     */
+    class DurationStats
+    {
+    public:
+        void Add(const uint64_t ns)
+        {
+            if (count_ == 0 || ns < min_) min_ = ns;
+            if (ns > max_) max_ = ns;
+            sum_ += ns;
+            ++count_;
+        }
+
+        void Reset()
+        {
+            *this = DurationStats();
+        }
+
+        uint64_t Min() const { return min_; }
+        uint64_t Max() const { return max_; }
+        uint64_t Avg() const { return count_ ? sum_ / count_ : 0; }
+        uint32_t Count() const { return count_; }
+
+    private:
+        uint64_t min_{};
+        uint64_t max_{};
+        uint64_t sum_{};
+        uint32_t count_{};
+    };
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Utils
+{
+    template <typename Signature, size_t Capacity = 4 * sizeof(void*)>
+    class InplaceFunction;
+
+    /**
+     * std::function without the heap: the callable is stored in Capacity bytes inside the object,
+     * a callable that does not fit fails to compile. Calling it is one indirect call through a
+     * function pointer stamped out per callable type.
+     */
+    template <typename R, typename... Args, size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity>
+    {
+    public:
+        InplaceFunction() = default;
+
+        template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+        InplaceFunction(F&& f) // NOLINT(google-explicit-constructor): converts like std::function
+        {
+            using Callable = std::decay_t<F>;
+            static_assert(sizeof(Callable) <= Capacity, "callable too large for this InplaceFunction");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "callable over-aligned");
+            static_assert(std::is_invocable_r_v<R, Callable&, Args...>, "callable has the wrong signature");
+
+            new(this->storage_.data()) Callable(std::forward<F>(f));
+            this->invoke_ = [](void* storage, Args... args) -> R
+            {
+                return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+            };
+            this->manage_ = [](void* dst, void* src, const Operation op)
+            {
+                if (op == Operation::Copy)
+                {
+                    new(dst) Callable(*static_cast<const Callable*>(src));
+                }
+                else
+                {
+                    static_cast<Callable*>(src)->~Callable();
+                }
+            };
+        }
+
+        InplaceFunction(const InplaceFunction& other) : invoke_(other.invoke_), manage_(other.manage_)
+        {
+            if (this->manage_ != nullptr)
+            {
+                this->manage_(this->storage_.data(), const_cast<std::byte*>(other.storage_.data()), Operation::Copy);
+            }
+        }
+
+        InplaceFunction& operator=(const InplaceFunction& other)
+        {
+            if (this != &other)
+            {
+                this->~InplaceFunction();
+                new(this) InplaceFunction(other);
+            }
+            return *this;
+        }
+
+        ~InplaceFunction()
+        {
+            if (this->manage_ != nullptr)
+            {
+                this->manage_(nullptr, this->storage_.data(), Operation::Destroy);
+            }
+            this->invoke_ = nullptr;
+            this->manage_ = nullptr;
+        }
+
+        explicit operator bool() const { return this->invoke_ != nullptr; }
+
+        R operator()(Args... args) const
+        {
+            // like std::function, a const call may invoke a mutable callable
+            return this->invoke_(const_cast<std::byte*>(this->storage_.data()), std::forward<Args>(args)...);
+        }
+
+    private:
+        enum class Operation : uint8_t { Copy, Destroy };
+
+        alignas(std::max_align_t) std::array<std::byte, Capacity> storage_{};
+        R (*invoke_)(void*, Args...) = nullptr;
+        void (*manage_)(void*, void*, Operation) = nullptr;
+    };
+}
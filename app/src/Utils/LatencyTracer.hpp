@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Utils/DurationStats.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/StreamingStats.hpp"
+#include "Utils/TimeStamp.hpp"
+#include "zephyr/kernel.h"
+#include "zephyr/spinlock.h"
+
+namespace Utils
+{
+    /**
+     * Latency of one stage: exact min/avg/max over the run, a streaming p99 estimate and the
+     * maximum of the last RecentCount samples, all O(1) per sample and per report.
+     */
+    class LatencyStats
+    {
+    public:
+        static constexpr size_t RecentCount = 64;
+
+        void Add(const uint64_t ns)
+        {
+            stats_.Add(ns);
+            p99_.Add(static_cast<float>(ns));
+            recent_.Add(static_cast<float>(ns));
+        }
+
+        // approximate 99th percentile, in ns
+        uint64_t P99() const { return static_cast<uint64_t>(p99_.Value()); }
+
+        // maximum of the last RecentCount samples: unlike Stats().Max(), start-up outliers age out
+        uint64_t RecentMax() const { return static_cast<uint64_t>(recent_.Max()); }
+
+        const DurationStats& Stats() const { return stats_; }
+
+    private:
+        DurationStats stats_{};
+        QuantileEstimator p99_{0.99f};
+        WindowedMinMax<RecentCount> recent_{};
+    };
+
+    enum class LatencyStage : uint8_t
+    {
+        Acquisition, // first sample of the frame captured -> frame reaches the DSP
+        Detection, // frame reaches the DSP -> beat published
+        Render, // beat published -> LED strip updated with the first frame showing it
+        Total, // first sample captured -> LED strip updated
+        Count
+    };
+
+    /**
+     * Collects per-stage latencies of the audio -> beat -> LED path.
+     * The beat in flight between detection and the next strip update is kept here, so the
+     * rendering side only has to report when a frame was pushed.
+     */
+    class LatencyTracer
+    {
+    public:
+        void Record(const LatencyStage stage, const uint64_t ns)
+        {
+            stages_[static_cast<size_t>(stage)].Add(ns);
+        }
+
+        // A beat was handed to the animations; remember it until the next strip update.
+        void BeatDispatched(const TimeStamp::Timestamp& captured, const TimeStamp::Timestamp& detected)
+        {
+            const auto key = k_spin_lock(&lock_);
+            pending_ = true;
+            captured_ = captured;
+            detected_ = detected;
+            k_spin_unlock(&lock_, key);
+        }
+
+        // The LED strip was updated; closes out the beat dispatched before, if any.
+        void FramePushed()
+        {
+            const auto now = TimeStamp::Timestamp::Now();
+
+            const auto key = k_spin_lock(&lock_);
+            const bool pending = pending_;
+            const auto captured = captured_;
+            const auto detected = detected_;
+            pending_ = false;
+            k_spin_unlock(&lock_, key);
+
+            if (!pending)
+            {
+                return;
+            }
+            Record(LatencyStage::Render, now.nSec - detected.nSec);
+            Record(LatencyStage::Total, now.nSec - captured.nSec);
+        }
+
+        const LatencyStats& Get(const LatencyStage stage) const
+        {
+            return stages_[static_cast<size_t>(stage)];
+        }
+
+        void Report(const Logger& logger) const
+        {
+            static constexpr const char* names[] = {"acquisition", "detection", "render", "total"};
+            for (size_t i = 0; i < static_cast<size_t>(LatencyStage::Count); ++i)
+            {
+                const auto& l = stages_[i];
+                if (l.Stats().Count() == 0)
+                {
+                    continue;
+                }
+                logger.info("latency %s: min %llu avg %llu p99 ~%llu max %llu (last %u: %llu) us (n=%u)", names[i],
+                            l.Stats().Min() / 1000, l.Stats().Avg() / 1000, l.P99() / 1000, l.Stats().Max() / 1000,
+                            static_cast<uint32_t>(LatencyStats::RecentCount), l.RecentMax() / 1000,
+                            l.Stats().Count());
+            }
+        }
+
+    private:
+        std::array<LatencyStats, static_cast<size_t>(LatencyStage::Count)> stages_{};
+
+        k_spinlock lock_{};
+        bool pending_{false};
+        TimeStamp::Timestamp captured_{};
+        TimeStamp::Timestamp detected_{};
+    };
+}
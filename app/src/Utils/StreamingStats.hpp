@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace Utils
+{
+    /**
+     * Exponential moving average: value += alpha * (x - value).
+     * Without an initial value the first sample seeds the average.
+     */
+    class Ema
+    {
+    public:
+        explicit Ema(const float alpha) : alpha_(alpha)
+        {
+        }
+
+        Ema(const float alpha, const float initial) : alpha_(alpha), value_(initial), seeded_(true)
+        {
+        }
+
+        float Add(const float x)
+        {
+            this->value_ = this->seeded_ ? this->value_ + this->alpha_ * (x - this->value_) : x;
+            this->seeded_ = true;
+            return this->value_;
+        }
+
+        float Value() const { return this->value_; }
+
+    private:
+        float alpha_;
+        float value_{};
+        bool seeded_{};
+    };
+
+    /**
+     * Mean and variance of the last N samples in O(1) per sample.
+     *
+     * The window starts out filled with zeros. Replacing the oldest sample updates mean and the sum
+     * of squared deviations with the windowed Welford step; every N samples both are recomputed
+     * from the ring so rounding errors cannot accumulate over long runs.
+     */
+    template <size_t N>
+    class WindowedStats
+    {
+        static_assert(N > 0, "window must not be empty");
+
+    public:
+        void Add(const float x)
+        {
+            const float oldest = this->ring_[this->index_];
+            this->ring_[this->index_] = x;
+            this->index_ = (this->index_ + 1) % N;
+
+            if (this->index_ == 0)
+            {
+                Renormalise();
+                return;
+            }
+            const float previousMean = this->mean_;
+            this->mean_ += (x - oldest) / static_cast<float>(N);
+            this->m2_ += (x - oldest) * (x - this->mean_ + oldest - previousMean);
+        }
+
+        float Mean() const { return this->mean_; }
+
+        // population variance over the window
+        float Variance() const
+        {
+            return this->m2_ > 0.0f ? this->m2_ / static_cast<float>(N) : 0.0f;
+        }
+
+        float StdDev() const { return std::sqrt(Variance()); }
+
+    private:
+        void Renormalise()
+        {
+            float sum = 0.0f;
+            for (const auto x : this->ring_)
+            {
+                sum += x;
+            }
+            this->mean_ = sum / static_cast<float>(N);
+            float m2 = 0.0f;
+            for (const auto x : this->ring_)
+            {
+                m2 += (x - this->mean_) * (x - this->mean_);
+            }
+            this->m2_ = m2;
+        }
+
+        std::array<float, N> ring_{};
+        size_t index_{};
+        float mean_{};
+        float m2_{};
+    };
+
+    /**
+     * Minimum and maximum of the last N samples, amortised O(1) per sample (monotonic queues).
+     */
+    template <size_t N>
+    class WindowedMinMax
+    {
+        static_assert(N > 0, "window must not be empty");
+
+    public:
+        void Add(const float x)
+        {
+            ++this->count_;
+            Push(this->min_, x, [](const float kept, const float added) { return kept <= added; });
+            Push(this->max_, x, [](const float kept, const float added) { return kept >= added; });
+        }
+
+        float Min() const { return this->min_.Front().value; }
+        float Max() const { return this->max_.Front().value; }
+
+    private:
+        struct Entry
+        {
+            uint32_t seq;
+            float value;
+        };
+
+        // ring-buffered deque, never holds more than N entries
+        struct Queue
+        {
+            std::array<Entry, N> entries{};
+            size_t head{};
+            size_t size{};
+
+            const Entry& Front() const { return this->entries[this->head]; }
+            const Entry& Back() const { return this->entries[(this->head + this->size - 1) % N]; }
+            void PopFront() { this->head = (this->head + 1) % N; --this->size; }
+            void PopBack() { --this->size; }
+            void PushBack(const Entry& e) { this->entries[(this->head + this->size++) % N] = e; }
+        };
+
+        template <typename Keep>
+        void Push(Queue& q, const float x, Keep keep)
+        {
+            while (q.size > 0 && !keep(q.Back().value, x))
+            {
+                q.PopBack();
+            }
+            // one sample leaves the window per sample added
+            if (q.size > 0 && this->count_ - q.Front().seq >= N)
+            {
+                q.PopFront();
+            }
+            q.PushBack({this->count_, x});
+        }
+
+        Queue min_{};
+        Queue max_{};
+        uint32_t count_{};
+    };
+
+    /**
+     * Streaming estimate of the q-quantile (0..1) in O(1) time and memory.
+     *
+     * Stochastic approximation: the estimate moves up by q * step for every sample above it and
+     * down by (1 - q) * step for every sample below, so it settles where a fraction q of the
+     * samples is below. The step follows the spread of the signal (EMA of |x - estimate|), which
+     * keeps the estimator scale free. Approximate by design; use a sorted window for exact values.
+     */
+    class QuantileEstimator
+    {
+    public:
+        explicit QuantileEstimator(const float q, const float rate = 0.05f) : q_(q), rate_(rate), spread_(rate)
+        {
+        }
+
+        float Add(const float x)
+        {
+            if (!this->seeded_)
+            {
+                this->estimate_ = x;
+                this->seeded_ = true;
+                return this->estimate_;
+            }
+            const float step = this->rate_ * this->spread_.Add(std::fabs(x - this->estimate_));
+            this->estimate_ += x > this->estimate_ ? this->q_ * step : -(1.0f - this->q_) * step;
+            return this->estimate_;
+        }
+
+        float Value() const { return this->estimate_; }
+
+    private:
+        float q_;
+        float rate_;
+        Ema spread_;
+        float estimate_{};
+        bool seeded_{};
+    };
+}
@@ -3,10 +3,24 @@
 //
 #pragma once
 
+#include <cstdint>
+
+#include "zephyr/kernel.h"
+
 namespace Utils::TimeStamp
 {
     struct Timestamp
     {
+        // Monotonic time since boot, comparable across threads, ISRs and modules.
+        static Timestamp Now()
+        {
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+            return {k_cyc_to_ns_floor64(k_cycle_get_64())};
+#else
+            return {k_ticks_to_ns_floor64(k_uptime_ticks())};
+#endif
+        }
+
         float GetUs() const
         {
             return nSec/1000.0f;
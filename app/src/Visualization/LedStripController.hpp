@@ -7,6 +7,8 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/led_strip.h>
 
+#include "Utils/LatencyTracer.hpp"
+
 namespace Visualization
 {
     class LedStripController
@@ -14,8 +16,8 @@ namespace Visualization
     public:
         typedef array<led_rgb, Constants::ChainLength> ledChain;
 
-        LedStripController(const device* ledStrip, Logger& logger)
-            : logger_(logger), led_strip_(ledStrip)
+        LedStripController(const device* ledStrip, LatencyTracer& latency, Logger& logger)
+            : logger_(logger), latency_(latency), led_strip_(ledStrip)
         {
         }
 
@@ -57,7 +59,9 @@ namespace Visualization
             if (ret != 0)
             {
                 this->logger_.error("Led strip update failed: %d.", ret);
+                return;
             }
+            this->latency_.FramePushed();
         }
 
     private:
@@ -69,6 +73,7 @@ namespace Visualization
         }
 
         Logger& logger_;
+        LatencyTracer& latency_;
         const device* led_strip_;
         ledChain leds_{};
     };
@@ -8,24 +8,39 @@
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/adc.h>
 #include <zephyr/logging/log.h>
-#include "zephyr/arch/xtensa/thread_stack.h"
 #include "zephyr/drivers/gpio.h"
 
 #include "Constants.hpp"
 
+#include <utility>
+
 #include "Core/MessagePublisher.hpp"
 #include "Core/MessageSubscriber.hpp"
 #include "Core/ThreadWorker.hpp"
 #include "Modules/AudioSamplingModule.hpp"
-#include "Modules/AudioProcessingModule.hpp"
+#if defined(CONFIG_APP_AMP_OFFLOAD)
+#include "Modules/AmpOffloadModule.hpp"
+#else
+#include "Modules/AnalysisChain.hpp"
+#endif
 #include "Modules/VisualizationModule.hpp"
 #include "Modules/InputModule.hpp"
 #include "ADC/AdcReader.hpp"
+#if defined(CONFIG_APP_PCM_REPLAY)
+#include "ADC/PcmReplaySource.hpp"
+#include "ADC/ReplayOptions.hpp"
+
+extern "C" {
+#include <cmdline.h>
+#include <posix_native_task.h>
+}
+#endif
+#if defined(CONFIG_APP_BEAT_EVALUATION)
+#include "Modules/BeatEvaluationModule.hpp"
+#endif
 #include "Core/EventTypes.hpp"
 #include "Visualization/LedControl.hpp"
 #include "Visualization/LedStripController.hpp"
-#include "SignalProcessing/FftProcessor.hpp"
-#include "SignalProcessing/LpFilter.hpp"
 
 
 #include "Utils/Logger.hpp"
@@ -57,30 +72,62 @@ static gpio_dt_spec signalLed= GPIO_DT_SPEC_GET(DT_NODELABEL(sigled), gpios);
 #endif
 static gpio_dt_spec loadSwitch = GPIO_DT_SPEC_GET_OR(DT_NODELABEL(loadswitch), gpios, {0});
 
+// lane 0 of the subscriber: beats, tempo, spectrum and buttons
 ZBUS_SUBSCRIBER_DEFINE(app_sub, 8);
+static constexpr int ControlLanePriority = 1;
+
+#if defined(CONFIG_APP_AMP_OFFLOAD)
+// frames and buttons share the single producer link to the APP CPU, one lane serves both
+#define AUDIO_LANE_OBSERVER app_sub
+static constexpr uint8_t AudioLane = 0;
+#else
+// the DSP runs in the audio frame handler: on a lane of its own, below beats and buttons
+ZBUS_SUBSCRIBER_DEFINE(audio_sub, 4);
+#define AUDIO_LANE_OBSERVER audio_sub
+static constexpr uint8_t AudioLane = 1;
+static constexpr int AudioLanePriority = 2;
+#endif
 
+auto audioFramePool = Core::AudioFramePool();
+
+#if defined(CONFIG_APP_AUDIO_RING_TOPIC)
+// each queued frame keeps its pool buffer until the audio lane has processed it
+static auto audioRing = zbus_cpp::RingChannel<Core::EventTypes::AudioFrame, Constants::AudioQueueDepth>(
+    [](const Core::EventTypes::AudioFrame& frame) { audioFramePool.Release(frame.frame); });
+#define AUDIO_TOPIC (&audioRing)
+#else
 ZBUS_CHAN_DEFINE_WITH_ID(
     AudioChannelBus,
-    0x348756834,
+    Core::EventTypes::ChannelId<Core::EventTypes::AudioFrame>,
     Core::EventTypes::AudioFrame,
     NULL, NULL,
-    ZBUS_OBSERVERS(app_sub),
+    ZBUS_OBSERVERS(AUDIO_LANE_OBSERVER),
     ZBUS_MSG_INIT({})
 );
+#define AUDIO_TOPIC (&AudioChannelBus)
+#endif
+
+// bounded FIFOs on lane 0: a burst of beats or presses must not collapse into the latest one
+static auto beatRing = zbus_cpp::RingChannel<Core::EventTypes::BeatEvent, 8>();
+static auto buttonRing = zbus_cpp::RingChannel<Core::EventTypes::ButtonEvent, 4>();
+// control: the debounce work item may wait for the ring rather than lose a press. It shares the
+// system workqueue with per-sample acquisition, but only waits with four presses pending. The DSP
+// thread publishes beats, tempo and spectra and never waits.
+static const k_timeout_t ButtonPublishTimeout = K_MSEC(50);
 
 ZBUS_CHAN_DEFINE_WITH_ID(
-    BeatChannelBus,
-    0x348756835,
-    Core::EventTypes::BeatEvent,
+    TempoChannelBus,
+    Core::EventTypes::ChannelId<Core::EventTypes::TempoEvent>,
+    Core::EventTypes::TempoEvent,
     NULL, NULL,
     ZBUS_OBSERVERS(app_sub),
     ZBUS_MSG_INIT({})
 );
 
 ZBUS_CHAN_DEFINE_WITH_ID(
-    ButtonChannelBus,
-    0x348756836,
-    Core::EventTypes::ButtonEvent,
+    SpectrumChannelBus,
+    Core::EventTypes::ChannelId<Core::EventTypes::SpectrumEvent>,
+    Core::EventTypes::SpectrumEvent,
     NULL, NULL,
     ZBUS_OBSERVERS(app_sub),
     ZBUS_MSG_INIT({})
@@ -92,48 +139,105 @@ ZBUS_CHAN_DEFINE_WITH_ID(
 //////////////////////////////////////////////////////////////////////////////////
 
 auto publisher = zbus_cpp::MessagePublisher(
-    zbus_cpp::Topic<Core::EventTypes::AudioFrame>{&AudioChannelBus},
-    zbus_cpp::Topic<Core::EventTypes::BeatEvent>{&BeatChannelBus},
-    zbus_cpp::Topic<Core::EventTypes::ButtonEvent>{&ButtonChannelBus});
+    zbus_cpp::Topic<Core::EventTypes::AudioFrame>{AUDIO_TOPIC},
+    zbus_cpp::Topic<Core::EventTypes::BeatEvent>{&beatRing},
+    zbus_cpp::Topic<Core::EventTypes::ButtonEvent>{&buttonRing}.Blocking(ButtonPublishTimeout),
+    zbus_cpp::Topic<Core::EventTypes::TempoEvent>{&TempoChannelBus},
+    zbus_cpp::Topic<Core::EventTypes::SpectrumEvent>{&SpectrumChannelBus});
 
-K_THREAD_STACK_DEFINE(messaging_thread_stack, Constants::SamplingFrameSize * 4 + 2048);
+K_THREAD_STACK_DEFINE(messaging_thread_stack, 2048);
 auto a = ThreadWorker(*messaging_thread_stack, K_THREAD_STACK_SIZEOF(messaging_thread_stack));
+#if !defined(CONFIG_APP_AMP_OFFLOAD)
+K_THREAD_STACK_DEFINE(audio_lane_stack, Constants::SamplingFrameSize * 4 + 2048);
+auto audioLaneWorker = ThreadWorker(*audio_lane_stack, K_THREAD_STACK_SIZEOF(audio_lane_stack));
+#endif
 auto subscriber = zbus_cpp::MessageSubscriber(
     a,
     &app_sub,
-    zbus_cpp::Topic<Core::EventTypes::AudioFrame>{&AudioChannelBus},
-    zbus_cpp::Topic<Core::EventTypes::BeatEvent>{&BeatChannelBus},
-    zbus_cpp::Topic<Core::EventTypes::ButtonEvent>{&ButtonChannelBus});
+    zbus_cpp::Topic<Core::EventTypes::AudioFrame>{AUDIO_TOPIC}.OnLane(AudioLane),
+    zbus_cpp::Topic<Core::EventTypes::BeatEvent>{&beatRing},
+    zbus_cpp::Topic<Core::EventTypes::ButtonEvent>{&buttonRing},
+    // small messages, short const handlers: read in place
+    zbus_cpp::Topic<Core::EventTypes::TempoEvent>{&TempoChannelBus}.ClaimOnRead(),
+    zbus_cpp::Topic<Core::EventTypes::SpectrumEvent>{&SpectrumChannelBus}.ClaimOnRead());
+
+auto latencyTracer = LatencyTracer();
 
 auto timer = PeriodicTimer();
+K_THREAD_STACK_DEFINE(adc_thread_stack, 1024);
+auto adcWorker = ThreadWorker(*adc_thread_stack, K_THREAD_STACK_SIZEOF(adc_thread_stack));
 auto adcLogger = Logger("ADC_READER");
-auto adc_reader = AdcReader(&adc_channels[0], timer, adcLogger);
+#if defined(CONFIG_APP_PCM_REPLAY)
+// constant initialised: the command line is parsed into it before the kernel boots
+constinit auto replayOptions = Adc::ReplayOptions();
+
+static void AddReplayOptions()
+{
+    // the table is C, its strings are never written through
+    static args_struct_t options[] = {
+        {.option = const_cast<char*>("track"), .name = const_cast<char*>("file"), .type = 's',
+         .dest = &replayOptions.track, .descript = const_cast<char*>("WAV or raw PCM file to replay")},
+#if defined(CONFIG_APP_BEAT_EVALUATION)
+        {.option = const_cast<char*>("beats"), .name = const_cast<char*>("file"), .type = 's',
+         .dest = &replayOptions.beats, .descript = const_cast<char*>("beat annotations of the track")},
+#endif
+        ARG_TABLE_ENDMARKER
+    };
+    native_add_command_line_opts(options);
+}
+NATIVE_TASK(AddReplayOptions, PRE_BOOT_1, 10);
+
+auto audioSource = Adc::PcmReplaySource(replayOptions, IS_ENABLED(CONFIG_APP_PCM_REPLAY_REALTIME), audioFramePool,
+                                        adcWorker, adcLogger);
+#else
+auto audioSource = AdcReader(adc_channels, audioFramePool, timer, adcWorker, adcLogger);
+#endif
 
 auto audioSamplingLogger = Logger("AUDIO_SAMPLING");
-auto audioSamplingModule = Modules::AudioSamplingModule(adc_reader, publisher, subscriber, audioSamplingLogger);
+auto audioSamplingModule = Modules::AudioSamplingModule(audioSource, audioFramePool, publisher, subscriber,
+                                                        audioSamplingLogger);
 
 auto ledLogger = Logger("LED_CONTROL");
 auto led = Visualization::LedControl(&signalLed, ledLogger);
 auto ledStripLogger = Logger("LED_STRIP");
-auto ledStripController = Visualization::LedStripController(strip, ledStripLogger);
-
-auto lpFilter = LpFilter();
-auto fftProcessor = FftProcessor();
-auto beatDetector = BeatDetector(fftProcessor, lpFilter);
+auto ledStripController = Visualization::LedStripController(strip, latencyTracer, ledStripLogger);
+
+#if defined(CONFIG_APP_AMP_OFFLOAD)
+// beat detection runs in the APP CPU image (main_appcpu.cpp)
+auto ampDoorbell = Core::IpmDoorbell(DEVICE_DT_GET(DT_CHOSEN(zephyr_ipc)));
+auto ampLink = Core::AmpHostLink(Core::AmpSharedMemory(), [] { ampDoorbell.Ring(); });
+K_THREAD_STACK_DEFINE(amp_thread_stack, 1024);
+auto ampWorker = ThreadWorker(*amp_thread_stack, K_THREAD_STACK_SIZEOF(amp_thread_stack));
+auto audioProcessingLogger = Logger("AMP_OFFLOAD");
+auto audioProcessingModule = Modules::AmpOffloadModule(publisher, subscriber, audioFramePool, ampLink, ampDoorbell,
+                                                       ampWorker, latencyTracer, audioProcessingLogger);
+static_assert(Constants::AudioChannelCount == CONFIG_APP_AMP_CHANNELS,
+              "the APP CPU image is built for a different channel count (SB_CONFIG_APP_AMP_CHANNELS)");
+#else
+auto analysisChain = Modules::AnalysisChain();
+auto signalProcessors = analysisChain.Processors();
 auto audioProcessingLogger = Logger("AUDIO_PROCESSING");
-auto audioProcessingModule = Modules::AudioProcessingModule(publisher, subscriber, beatDetector, audioProcessingLogger);
+auto audioProcessingModule = Modules::AudioProcessingModule(publisher, subscriber, audioFramePool, signalProcessors,
+                                                            latencyTracer, audioProcessingLogger);
+#endif
 
 auto visualizationLogger = Logger("VISUALIZATION");
 auto frameTimer = PeriodicTimer();
 auto loadSwitchLogger = Logger("LOAD_SWITCH");
 auto loadSwitchControl = LoadSwitch(&loadSwitch, loadSwitchLogger);
 auto animationControl = Animations::AnimationControl(frameTimer, ledStripController, led);
-auto visualizationModule = Modules::VisualizationModule(subscriber, visualizationLogger, animationControl, loadSwitchControl);
+auto visualizationModule = Modules::VisualizationModule(subscriber, visualizationLogger, animationControl, loadSwitchControl,
+                                                        latencyTracer);
 
 auto animCtrlButton = UtilsButton::Button(ctrlButton);
 auto buttonLogger = Logger("BUTTON");
 auto inputModule = Modules::InputModule(publisher, animCtrlButton, buttonLogger);
 
+#if defined(CONFIG_APP_BEAT_EVALUATION)
+auto evaluationLogger = Logger("BEAT_EVALUATION");
+auto beatEvaluationModule = Modules::BeatEvaluationModule(subscriber, replayOptions, evaluationLogger);
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////////
 /************************ application start **************************************/
@@ -143,7 +247,13 @@ int main()
 {
     LOG_INF("App started.");
 
-    subscriber.Initialize(1);
+    subscriber.Initialize(ControlLanePriority);
+#if !defined(CONFIG_APP_AMP_OFFLOAD)
+    if (subscriber.AddLane(audioLaneWorker, &audio_sub, AudioLanePriority) != AudioLane)
+    {
+        LOG_ERR("Audio lane could not be added.");
+    }
+#endif
     subscriber.Start();
 
     //Module initialization
@@ -151,10 +261,17 @@ int main()
     audioSamplingModule.Initialize();
     audioProcessingModule.Initialize();
     visualizationModule.Initialize();
+#if defined(CONFIG_APP_BEAT_EVALUATION)
+    beatEvaluationModule.Initialize();
+    audioSource.OnFinished([] { beatEvaluationModule.Finish(); });
+#endif
 
     led.Set(true);
 
     //Module startup
+#if defined(CONFIG_APP_BEAT_EVALUATION)
+    beatEvaluationModule.Start();
+#endif
     audioProcessingModule.Start();
     audioSamplingModule.Start();
     visualizationModule.Start();
@@ -0,0 +1,124 @@
+/*
+ * APP CPU image of an AMP build (CONFIG_APP_AMP_REMOTE, built by sysbuild next to main.cpp):
+ * beat detection only. Frames arrive from the PRO CPU over the shared ring, results go back the
+ * same way; see Modules/AmpRemoteModule.hpp and Modules/AmpOffloadModule.hpp.
+ */
+
+#include <autoconf.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "Constants.hpp"
+
+#include "Core/AmpMessages.hpp"
+#include "Core/IpmDoorbell.hpp"
+#include "Core/MessagePublisher.hpp"
+#include "Core/MessageSubscriber.hpp"
+#include "Core/ThreadWorker.hpp"
+#include "Core/EventTypes.hpp"
+#include "Modules/AmpRemoteModule.hpp"
+#include "Modules/AnalysisChain.hpp"
+#include "Modules/AudioProcessingModule.hpp"
+
+#include "Utils/Logger.hpp"
+
+LOG_MODULE_REGISTER(AppCpu, CONFIG_APP_LOG_LEVEL);
+
+
+//////////////////////////////////////////////////////////////////////////////////
+/****************************** DI **********************************************/
+//////////////////////////////////////////////////////////////////////////////////
+
+ZBUS_SUBSCRIBER_DEFINE(app_sub, 8);
+
+ZBUS_CHAN_DEFINE_WITH_ID(
+    AudioChannelBus,
+    Core::EventTypes::ChannelId<Core::EventTypes::AudioFrame>,
+    Core::EventTypes::AudioFrame,
+    NULL, NULL,
+    ZBUS_OBSERVERS(app_sub),
+    ZBUS_MSG_INIT({})
+);
+
+// bounded FIFOs as on the PRO CPU; tempo stays latest-wins, its only subscriber is the publishing thread
+static auto beatRing = zbus_cpp::RingChannel<Core::EventTypes::BeatEvent, 8>();
+static auto buttonRing = zbus_cpp::RingChannel<Core::EventTypes::ButtonEvent, 4>();
+
+ZBUS_CHAN_DEFINE_WITH_ID(
+    TempoChannelBus,
+    Core::EventTypes::ChannelId<Core::EventTypes::TempoEvent>,
+    Core::EventTypes::TempoEvent,
+    NULL, NULL,
+    ZBUS_OBSERVERS(app_sub),
+    ZBUS_MSG_INIT({})
+);
+
+ZBUS_CHAN_DEFINE_WITH_ID(
+    SpectrumChannelBus,
+    Core::EventTypes::ChannelId<Core::EventTypes::SpectrumEvent>,
+    Core::EventTypes::SpectrumEvent,
+    NULL, NULL,
+    ZBUS_OBSERVERS(app_sub),
+    ZBUS_MSG_INIT({})
+);
+
+auto publisher = zbus_cpp::MessagePublisher(
+    zbus_cpp::Topic<Core::EventTypes::AudioFrame>{&AudioChannelBus},
+    zbus_cpp::Topic<Core::EventTypes::BeatEvent>{&beatRing},
+    zbus_cpp::Topic<Core::EventTypes::ButtonEvent>{&buttonRing},
+    zbus_cpp::Topic<Core::EventTypes::TempoEvent>{&TempoChannelBus},
+    zbus_cpp::Topic<Core::EventTypes::SpectrumEvent>{&SpectrumChannelBus});
+
+// sized like the PRO CPU's audio lane for the AudioProcessingModule's analysis chain; the
+// AmpRemoteModule's handlers stage their messages in a member and add nothing frame-sized
+K_THREAD_STACK_DEFINE(messaging_thread_stack, Constants::SamplingFrameSize * 4 + 2048);
+auto a = ThreadWorker(*messaging_thread_stack, K_THREAD_STACK_SIZEOF(messaging_thread_stack));
+auto subscriber = zbus_cpp::MessageSubscriber(
+    a,
+    &app_sub,
+    zbus_cpp::Topic<Core::EventTypes::AudioFrame>{&AudioChannelBus},
+    zbus_cpp::Topic<Core::EventTypes::BeatEvent>{&beatRing},
+    zbus_cpp::Topic<Core::EventTypes::ButtonEvent>{&buttonRing},
+    zbus_cpp::Topic<Core::EventTypes::TempoEvent>{&TempoChannelBus},
+    zbus_cpp::Topic<Core::EventTypes::SpectrumEvent>{&SpectrumChannelBus});
+
+auto audioFramePool = Core::AudioFramePool();
+auto latencyTracer = LatencyTracer();
+
+auto ampDoorbell = Core::IpmDoorbell(DEVICE_DT_GET(DT_CHOSEN(zephyr_ipc)));
+auto ampLink = Core::AmpRemoteLink(Core::AmpSharedMemory(), [] { ampDoorbell.Ring(); });
+// no frame-sized locals: the AmpRemoteModule receives into a member and copies straight into the pool
+K_THREAD_STACK_DEFINE(amp_thread_stack, 1024);
+auto ampWorker = ThreadWorker(*amp_thread_stack, K_THREAD_STACK_SIZEOF(amp_thread_stack));
+auto ampLogger = Logger("AMP_REMOTE");
+auto ampRemoteModule = Modules::AmpRemoteModule(publisher, subscriber, audioFramePool, ampLink, ampDoorbell, ampWorker,
+                                                ampLogger);
+
+auto analysisChain = Modules::AnalysisChain();
+auto signalProcessors = analysisChain.Processors();
+auto audioProcessingLogger = Logger("AUDIO_PROCESSING");
+auto audioProcessingModule = Modules::AudioProcessingModule(publisher, subscriber, audioFramePool, signalProcessors,
+                                                            latencyTracer, audioProcessingLogger);
+
+
+///////////////////////////////////////////////////////////////////////////////////
+/************************ application start **************************************/
+///////////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    LOG_INF("APP CPU started.");
+
+    subscriber.Initialize(1);
+    subscriber.Start();
+
+    ampRemoteModule.Initialize();
+    audioProcessingModule.Initialize();
+
+    audioProcessingModule.Start();
+    ampRemoteModule.Start();
+
+    LOG_INF("Beat detection running...");
+
+    k_sleep(K_FOREVER);
+}
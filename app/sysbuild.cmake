@@ -0,0 +1,22 @@
+# SPDX-License-Identifier: Apache-2.0
+#
+# AMP build (SB_CONFIG_APP_AMP_OFFLOAD): a second image of this app runs the beat detection on the
+# ESP32-S3 APP CPU, e.g.
+#   west build --sysbuild -b esp32s3_control_board/esp32s3/procpu app -- -DSB_CONFIG_APP_AMP_OFFLOAD=y
+# DSP options have to be given to both images (-D<option> and -Dappcpu_<option>).
+
+if(SB_CONFIG_APP_AMP_OFFLOAD)
+  ExternalZephyrProject_Add(
+    APPLICATION appcpu
+    SOURCE_DIR ${APP_DIR}
+    BOARD ${SB_CONFIG_APP_AMP_REMOTE_BOARD}
+  )
+  set_config_bool(appcpu CONFIG_APP_AMP_REMOTE y)
+  set_config_int(appcpu CONFIG_APP_AMP_CHANNELS ${SB_CONFIG_APP_AMP_CHANNELS})
+
+  set_config_bool(${DEFAULT_IMAGE} CONFIG_APP_AMP_OFFLOAD y)
+  set_config_int(${DEFAULT_IMAGE} CONFIG_APP_AMP_CHANNELS ${SB_CONFIG_APP_AMP_CHANNELS})
+
+  add_dependencies(${DEFAULT_IMAGE} appcpu)
+  sysbuild_add_dependencies(FLASH ${DEFAULT_IMAGE} appcpu)
+endif()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Scores the beat detection on a corpus of annotated tracks.
+
+Needs a native_sim build with CONFIG_APP_BEAT_EVALUATION, best replaying as fast as possible:
+
+    west build -b native_sim app -- -DCONFIG_APP_PCM_REPLAY=y -DCONFIG_APP_BEAT_EVALUATION=y \\
+        -DCONFIG_APP_PCM_REPLAY_REALTIME=n
+    scripts/beat_evaluation.py build/zephyr/zephyr.exe corpus/ > results.json
+
+Every *.wav / *.raw below the corpus directory with an annotation file of the same name
+(.beats or .txt, next to it or below --annotations) is replayed once with
+zephyr.exe -track=<file> -beats=<file>. The result is one JSON document on stdout: the line each
+run printed, plus totals over the corpus (precision/recall/F-measure over all beats, mean
+F-measure over the tracks, latency and ns/frame weighted by matches and frames).
+"""
+
+import argparse
+import json
+import pathlib
+import subprocess
+import sys
+
+AUDIO_SUFFIXES = (".wav", ".raw")
+ANNOTATION_SUFFIXES = (".beats", ".txt")
+
+
+def find_annotations(track, corpus, annotations):
+    for directory in (track.parent, annotations / track.parent.relative_to(corpus) if annotations else None):
+        if directory is None:
+            continue
+        for suffix in ANNOTATION_SUFFIXES:
+            candidate = directory / (track.stem + suffix)
+            if candidate.is_file():
+                return candidate
+    return None
+
+
+def run_track(exe, track, beats, sim_args, timeout):
+    try:
+        proc = subprocess.run([str(exe.resolve()), f"-track={track}", f"-beats={beats}", *sim_args],
+                              capture_output=True, text=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return {"track": str(track), "error": f"no result after {timeout} s"}
+    for line in proc.stdout.splitlines():
+        if line.startswith('{"track"'):
+            return json.loads(line)
+    return {"track": str(track), "error": f"no result, exit code {proc.returncode}"}
+
+
+def totals(results):
+    scored = [r for r in results if "error" not in r]
+    annotated = sum(r["annotated"] for r in scored)
+    detected = sum(r["detected"] for r in scored)
+    matched = sum(r["matched"] for r in scored)
+    frames = sum(r["frames"] for r in scored)
+    precision = matched / detected if detected else 0.0
+    recall = matched / annotated if annotated else 0.0
+    return {
+        "tracks": len(scored),
+        "failed": len(results) - len(scored),
+        "annotated": annotated,
+        "detected": detected,
+        "matched": matched,
+        "precision": round(precision, 4),
+        "recall": round(recall, 4),
+        "f_measure": round(2 * precision * recall / (precision + recall), 4) if precision + recall else 0.0,
+        "mean_track_f_measure": round(sum(r["f_measure"] for r in scored) / len(scored), 4) if scored else 0.0,
+        "latency_ms_mean": round(sum(r["latency_ms"]["mean"] * r["matched"] for r in scored) / matched, 2)
+        if matched else 0.0,
+        "ns_per_frame": round(sum(r["ns_per_frame"] * r["frames"] for r in scored) / frames) if frames else 0,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("exe", type=pathlib.Path, help="zephyr.exe of the evaluation build")
+    parser.add_argument("corpus", type=pathlib.Path, help="directory with the tracks")
+    parser.add_argument("--annotations", type=pathlib.Path,
+                        help="directory tree with the annotations, if not next to the tracks")
+    parser.add_argument("--timeout", type=float, default=600.0, help="seconds per track")
+    parser.add_argument("sim_args", nargs="*", help="passed on to zephyr.exe, after --")
+    args = parser.parse_args()
+
+    results = []
+    for track in sorted(p for p in args.corpus.rglob("*") if p.suffix.lower() in AUDIO_SUFFIXES):
+        beats = find_annotations(track, args.corpus, args.annotations)
+        if beats is None:
+            print(f"{track}: no annotations, skipped", file=sys.stderr)
+            continue
+        result = run_track(args.exe, track, beats, args.sim_args, args.timeout)
+        print(f"{track}: {result.get('error') or 'F ' + str(result['f_measure'])}", file=sys.stderr)
+        results.append(result)
+
+    json.dump({"results": results, "totals": totals(results)}, sys.stdout, indent=2)
+    print()
+    return 1 if not results or any("error" in r for r in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
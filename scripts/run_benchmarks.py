@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""Runs the native_sim benchmarks of one or more builds and collects their results.
+
+Build tests/benchmarks once per configuration to compare, e.g. with twister (one build per
+scenario of tests/benchmarks/testcase.yaml) or by hand:
+
+    west build -b native_sim -d build/bench tests/benchmarks
+    west build -b native_sim -d build/bench_per_sample tests/benchmarks -- \\
+        -DCONFIG_APP_ADC_SEQUENCE_ACQUISITION=n
+    scripts/run_benchmarks.py build/bench/zephyr/zephyr.exe build/bench_per_sample/zephyr/zephyr.exe
+
+Every benchmark prints one JSON line per variant, tagged with "bench" and the "build" it ran in.
+The result is one JSON document on stdout: the lines grouped by benchmark, plus the comparisons
+that need more than one line (e.g. one acquisition mode against the other). CPU times are host
+wall clock and only meaningful relative to each other; waiting and jitter are simulated time.
+"""
+
+import argparse
+import json
+import pathlib
+import subprocess
+import sys
+
+TOLERANCE_MS = 70.0  # as BeatEvaluationModule
+
+
+def run_build(exe, sim_args, timeout):
+    try:
+        proc = subprocess.run([str(exe.resolve()), *sim_args], capture_output=True, text=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return [], f"not done after {timeout} s"
+    lines = [json.loads(line) for line in proc.stdout.splitlines() if line.startswith('{"bench"')]
+    if "benchmarks done" not in proc.stdout:
+        return lines, f"not done, exit code {proc.returncode}"
+    return lines, None
+
+
+def compare_adc_acquisition(lines):
+    modes = {r["mode"]: r for r in lines if "error" not in r}
+    if "sequence" not in modes or "per_sample" not in modes:
+        return None
+    sequence, per_sample = modes["sequence"], modes["per_sample"]
+    return {
+        "frame_jitter_us": {m: r["frame_interval_us"]["max"] - r["frame_interval_us"]["min"] for m, r in modes.items()},
+        "probe_delay_max_us": {m: r["probe_delay_us"]["max"] for m, r in modes.items()},
+        "cpu_per_frame_max_ns": {m: r["cpu_per_frame_ns"]["max"] for m, r in modes.items()},
+        "probe_delay_avg_ratio": round(per_sample["probe_delay_us"]["avg"] / sequence["probe_delay_us"]["avg"], 2)
+        if sequence["probe_delay_us"]["avg"] else None,
+    }
+
+
+def compare_frame_transport(lines):
+    result = {}
+    for build in sorted({r["build"] for r in lines}):
+        transports = {r["transport"]: r for r in lines if r["build"] == build}
+        if "by_value" in transports and "handle" in transports:
+            by_value, handle = transports["by_value"], transports["handle"]
+            result[build] = {
+                "bytes_copied_saved_per_frame": by_value["bytes_copied_per_frame"] - handle["bytes_copied_per_frame"],
+                "bus_buffer_bytes_saved": by_value["bus_buffer_bytes"] - handle["bus_buffer_bytes"],
+                "speedup": round(by_value["ns_per_frame"] / handle["ns_per_frame"], 2) if handle["ns_per_frame"] else None,
+            }
+    return result or None
+
+
+def score(kick_frames, track):
+    """Precision/recall of the detected kick frames against the track's kicks, matched as in
+    BeatEvaluationModule: nearest unmatched kick within +-TOLERANCE_MS of the frame's span."""
+    frame_ms = track["frame_ms"]
+    kicks = track["kicks_ms"]
+    matched = [False] * len(kicks)
+    hits = 0
+    for frame in kick_frames:
+        start, end = frame * frame_ms, (frame + 1) * frame_ms
+        best, best_distance = None, TOLERANCE_MS
+        for i, kick in enumerate(kicks):
+            distance = start - kick if kick < start else kick - end if kick > end else 0.0
+            if distance <= best_distance and not matched[i]:
+                best, best_distance = i, distance
+        if best is not None:
+            matched[best] = True
+            hits += 1
+    precision = hits / len(kick_frames) if kick_frames else 0.0
+    recall = hits / len(kicks) if kicks else 0.0
+    return {
+        "precision": round(precision, 4),
+        "recall": round(recall, 4),
+        "f_measure": round(2 * precision * recall / (precision + recall), 4) if precision + recall else 0.0,
+    }
+
+
+def agreement(a, b, slack):
+    """Share of kick decisions two runs have in common, a frame apart at most slack frames."""
+    unmatched = list(b)
+    common = 0
+    for frame in a:
+        near = [f for f in unmatched if abs(f - frame) <= slack]
+        if near:
+            unmatched.remove(min(near, key=lambda f: abs(f - frame)))
+            common += 1
+    return round(2 * common / (len(a) + len(b)), 4) if a or b else 1.0
+
+
+def detector_results(lines, tracks):
+    """Score of every detector line, keyed by build and variant."""
+    return {
+        f'{r["build"]}/{r["variant"]}': {"ns_per_frame": r["ns_per_frame"], **score(r["kick_frames"], tracks[r["build"]])}
+        for r in lines if r["build"] in tracks
+    }
+
+
+def compare_sample_format(lines, tracks):
+    result = {"scores": detector_results(lines, tracks), "q15_vs_float": {}}
+    runs = {(r["build"], r["variant"]): r for r in lines}
+    for (build, variant), q15 in runs.items():
+        if not build.startswith("q15"):
+            continue
+        other = runs.get((build.replace("q15", "float", 1), variant))
+        if other is None:
+            continue
+        result["q15_vs_float"][f"{build}/{variant}"] = {
+            "speedup": round(other["ns_per_frame"] / q15["ns_per_frame"], 2) if q15["ns_per_frame"] else None,
+            "agreement_same_frame": agreement(q15["kick_frames"], other["kick_frames"], 0),
+            "agreement_one_frame": agreement(q15["kick_frames"], other["kick_frames"], 1),
+        }
+    return result
+
+
+def compare_decimation(lines, tracks):
+    result = {"scores": detector_results(lines, tracks), "decimated_speedup": {}}
+    runs = {(r["build"], r["variant"]): r for r in lines}
+    for (build, variant), decimated in runs.items():
+        full_rate = runs.get((build, "full_rate"))
+        if variant == "decimated" and full_rate is not None and decimated["ns_per_frame"]:
+            result["decimated_speedup"][build] = round(full_rate["ns_per_frame"] / decimated["ns_per_frame"], 2)
+    return result
+
+
+def compare_fft(lines):
+    result = {}
+    for build in sorted({r["build"] for r in lines}):
+        variants = {r["variant"]: r for r in lines if r["build"] == build}
+        baseline = variants.get("rectangular_magnitude_all")
+        if baseline is None:
+            continue
+        result[build] = {v: round(baseline["ns_per_call"] / r["ns_per_call"], 2) if r["ns_per_call"] else None
+                         for v, r in variants.items()}
+    return {"speedup_over_rectangular_magnitude_all": result} if result else None
+
+
+def compare_ring_transport(lines):
+    result = {}
+    for build in sorted({r["build"] for r in lines}):
+        runs = {(r["type"], r["transport"]): r for r in lines if r["build"] == build}
+        for message in sorted({t for t, _ in runs}):
+            zbus, ring = runs.get((message, "zbus")), runs.get((message, "ring"))
+            if zbus is None or ring is None:
+                continue
+            result.setdefault(build, {})[message] = {
+                "round_trip_speedup": round(zbus["round_trip_ns"] / ring["round_trip_ns"], 2)
+                if ring["round_trip_ns"] else None,
+                "throughput_ratio": round(ring["messages_per_s"] / zbus["messages_per_s"], 2)
+                if zbus["messages_per_s"] else None,
+            }
+    return {"ring_over_zbus": result} if result else None
+
+
+def compare_dispatch(lines):
+    result = {}
+    for build in sorted({r["build"] for r in lines}):
+        runs = {(r["bytes"], r["mode"]): r for r in lines if r["build"] == build}
+        for size in sorted({b for b, _ in runs}):
+            copy, claim = runs.get((size, "copy")), runs.get((size, "claim"))
+            if copy is not None and claim is not None:
+                result.setdefault(build, {})[str(size)] = copy["ns_per_message"] - claim["ns_per_message"]
+    return {"ns_saved_by_claim": result} if result else None
+
+
+# benchmark -> function of all its lines and the synthetic track of each build, for results across builds
+COMPARISONS = {
+    "adc_acquisition": lambda lines, tracks: compare_adc_acquisition(lines),
+    "frame_transport": lambda lines, tracks: compare_frame_transport(lines),
+    "ring_transport": lambda lines, tracks: compare_ring_transport(lines),
+    "dispatch": lambda lines, tracks: compare_dispatch(lines),
+    "sample_format": compare_sample_format,
+    "decimation": compare_decimation,
+    "beat_engines": lambda lines, tracks: detector_results(lines, tracks) or None,
+    "fft": lambda lines, tracks: compare_fft(lines),
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("exes", type=pathlib.Path, nargs="+", help="zephyr.exe of each benchmark build")
+    parser.add_argument("--timeout", type=float, default=600.0, help="seconds per build")
+    parser.add_argument("--sim-arg", action="append", default=[], dest="sim_args",
+                        help="passed on to every zephyr.exe, may be repeated")
+    args = parser.parse_args()
+
+    benches = {}
+    errors = {}
+    for exe in args.exes:
+        lines, error = run_build(exe, args.sim_args, args.timeout)
+        print(f"{exe}: {error or str(len(lines)) + ' results'}", file=sys.stderr)
+        if error:
+            errors[str(exe)] = error
+        for line in lines:
+            benches.setdefault(line["bench"], []).append(line)
+
+    tracks = {r["build"]: r for r in benches.get("synthetic_track", [])}
+    comparisons = {}
+    for bench, compare in COMPARISONS.items():
+        if bench in benches and (result := compare(benches[bench], tracks)) is not None:
+            comparisons[bench] = result
+
+    json.dump({"results": benches, "comparisons": comparisons, "errors": errors}, sys.stdout, indent=2)
+    print()
+    return 1 if errors or not benches else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
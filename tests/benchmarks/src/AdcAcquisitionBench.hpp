@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Bench.hpp"
+#include "ADC/AdcReader.hpp"
+#include "Core/FramePool.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/PeriodicTimer.hpp"
+
+namespace Benchmarks::AdcAcquisition
+{
+    /**
+     * AdcReader in the acquisition mode of the build (CONFIG_APP_ADC_SEQUENCE_ACQUISITION) on the
+     * ADC emulator, next to another user of the system workqueue: a probe submitted every
+     * ProbePeriod_us that keeps the queue busy for ProbeBusy_us. Per-sample acquisition queues
+     * one work item per sample behind it and delays it in turn; a sequence wakes the queue once
+     * per frame. Reported in simulated time: sample and frame intervals, how late the probe ran,
+     * the reader's CPU time per frame. A sequence has no sample interval of its own: the ADC's
+     * hardware timer spaces its samples, "sample_timing" says which clock did.
+     *
+     * cpu_per_frame_ns is in ns, as it is far below a sample period. Simulated time stands still
+     * while a thread computes, so on native_sim it only holds what the ADC driver waits for; on
+     * the board it is the figure AdcReader logs.
+     *
+     * Runs last: a stopped reader still finishes the frame it is acquiring.
+     */
+    static constexpr uint32_t Frames = 150; // below the reader's statistics period
+    static constexpr uint32_t ProbePeriod_us = 1000;
+    static constexpr uint32_t ProbeBusy_us = 200;
+
+    struct Probe
+    {
+        k_timer timer;
+        k_work work;
+        uint64_t expired_cycles;
+        Utils::DurationStats delay_ns;
+    };
+
+    inline Probe probe{};
+
+    inline void ProbeExpired(k_timer*)
+    {
+        probe.expired_cycles = k_cycle_get_64();
+        k_work_submit(&probe.work);
+    }
+
+    inline void ProbeWork(k_work*)
+    {
+        probe.delay_ns.Add(k_cyc_to_ns_floor64(k_cycle_get_64() - probe.expired_cycles));
+        k_busy_wait(ProbeBusy_us);
+    }
+
+    K_THREAD_STACK_DEFINE(sequence_stack, 2048);
+    K_SEM_DEFINE(acquired, 0, 1);
+
+    template <size_t N>
+    void Run(const adc_dt_spec (&channels)[N])
+    {
+        static auto pool = Core::AudioFramePool();
+        static auto timer = Utils::PeriodicTimer();
+        static auto worker = Utils::ThreadWorker(*sequence_stack, K_THREAD_STACK_SIZEOF(sequence_stack));
+        static auto logger = Logger("ADC_BENCH");
+        static auto reader = Adc::AdcReader(channels, pool, timer, worker, logger);
+        static uint32_t frames = 0;
+
+        if (const auto err = reader.Initialize(); err != 0)
+        {
+            printk("{\"bench\":\"adc_acquisition\",\"build\":\"%s\",\"error\":%d}\n", Build(), err);
+            return;
+        }
+
+        k_work_init(&probe.work, ProbeWork);
+        k_timer_init(&probe.timer, ProbeExpired, nullptr);
+        k_timer_start(&probe.timer, K_USEC(ProbePeriod_us), K_USEC(ProbePeriod_us));
+
+        reader.Start([](int, const Core::FrameHandle& frame, const Utils::TimeStamp::Timestamp&)
+        {
+            pool.Release(frame);
+            if (++frames == Frames)
+            {
+                k_sem_give(&acquired);
+            }
+        }, 0);
+        const int res = k_sem_take(&acquired, K_SECONDS(Frames));
+        reader.Stop();
+        k_timer_stop(&probe.timer);
+        // let the frame in flight and the last probe complete
+        k_sleep(K_MSEC(50));
+
+        const auto& stats = reader.GetStatistics();
+        constexpr bool sequence = IS_ENABLED(CONFIG_APP_ADC_SEQUENCE_ACQUISITION);
+        printk("{\"bench\":\"adc_acquisition\",\"build\":\"%s\",\"mode\":\"%s\",\"frames\":%u,\"complete\":%s,"
+               "\"sample_timing\":\"%s\",",
+               Build(), sequence ? "sequence" : "per_sample", frames, res == 0 ? "true" : "false",
+               sequence ? "adc_hardware" : "k_timer");
+        if (!sequence)
+        {
+            PrintUs("sample_interval_us", stats.sampleInterval_ns);
+            printk(",");
+        }
+        PrintUs("frame_interval_us", stats.frameInterval_ns);
+        printk(",");
+        PrintUs("probe_delay_us", probe.delay_ns);
+        printk(",\"cpu_per_frame_ns\":{\"avg\":%llu,\"max\":%llu},\"overruns\":%u}\n", stats.cpuPerFrame_ns.Avg(),
+               stats.cpuPerFrame_ns.Max(), reader.GetOverruns());
+    }
+}
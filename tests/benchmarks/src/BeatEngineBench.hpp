@@ -0,0 +1,29 @@
+#pragma once
+
+#include "DetectorBench.hpp"
+#include "SignalProcessing/BeatDetector.hpp"
+#include "SignalProcessing/SpectralFluxDetector.hpp"
+
+namespace Benchmarks::BeatEngines
+{
+    /**
+     * Both beat engines (CONFIG_APP_BEAT_ENGINE_*) behind the front end of the build, on the same
+     * frames: scripts/run_benchmarks.py reports precision/recall of their kicks against the track
+     * and ns/frame. The track's sustained bass in the middle third is where they differ.
+     */
+    inline void Run()
+    {
+        using namespace SignalProcessing;
+
+        static AnalysisFft fft{};
+        static AnalysisFrontEnd energyFrontEnd{};
+        static auto energy = AnalysisBeatDetector(fft, energyFrontEnd);
+        (void)energy.Initialize();
+        Detectors::Run("beat_engines", "band_energy", energy);
+
+        static AnalysisFrontEnd fluxFrontEnd{};
+        static auto flux = AnalysisSpectralFluxDetector(fft, fluxFrontEnd);
+        (void)flux.Initialize();
+        Detectors::Run("beat_engines", "spectral_flux", flux);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Constants.hpp"
+#include "Utils/DurationStats.hpp"
+
+extern "C" {
+#include <native_rtc.h>
+#include <zephyr/sys/printk.h>
+}
+
+namespace Benchmarks
+{
+    /**
+     * Host wall clock. On native_sim simulated time stands still while a thread computes, so CPU
+     * cost is measured on the host; compare variants against each other, not with the board.
+     * Waiting, sampling intervals and jitter are simulated time (k_cycle_get, timing_counter_get).
+     */
+    inline uint64_t HostNow_ns()
+    {
+        return native_rtc_gettime_us(RTC_CLOCK_REALTIME) * 1000;
+    }
+
+    // mean host ns per call of f, over enough calls to hide the microsecond clock
+    template <typename F>
+    uint64_t NsPerCall(const uint32_t calls, F&& f)
+    {
+        // caches, lazily built tables
+        f();
+        const auto start = HostNow_ns();
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            f();
+        }
+        return (HostNow_ns() - start) / calls;
+    }
+
+    // the configuration the results belong to, part of every line
+    inline const char* Build()
+    {
+#if defined(CONFIG_APP_DSP_Q15) && defined(CONFIG_APP_DSP_DECIMATION)
+        return "q15+decimation";
+#elif defined(CONFIG_APP_DSP_Q15)
+        return "q15";
+#elif defined(CONFIG_APP_DSP_DECIMATION)
+        return "float+decimation";
+#else
+        return "float";
+#endif
+    }
+
+    // "name":{"min":..,"avg":..,"max":..} in us, for the result lines
+    inline void PrintUs(const char* name, const Utils::DurationStats& ns)
+    {
+        printk("\"%s\":{\"min\":%llu,\"avg\":%llu,\"max\":%llu}", name, ns.Min() / 1000, ns.Avg() / 1000,
+               ns.Max() / 1000);
+    }
+}
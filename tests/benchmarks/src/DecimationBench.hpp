@@ -0,0 +1,34 @@
+#pragma once
+
+#include "DetectorBench.hpp"
+#include "SignalProcessing/BeatDetector.hpp"
+
+namespace Benchmarks::Decimation
+{
+    /**
+     * The band energy detector behind the polyphase decimator (1.25 kHz, 128-point FFT) against
+     * the same detector at the full rate (low-pass, 512-point FFT), on the same frames. Only in a
+     * CONFIG_APP_DSP_DECIMATION build: without it the hi-hat band lies above the decimated
+     * Nyquist frequency and the full-rate chain is what sample_format already measures.
+     */
+    inline void Run()
+    {
+#if defined(CONFIG_APP_DSP_DECIMATION)
+        using namespace SignalProcessing;
+        using FullRateFrontEnd = LpFilter<Constants::SampleRate_hz, Constants::SamplingFrameSize>;
+        using FullRateDetector = BeatDetector<FullRateFrontEnd, 512>;
+
+        static AnalysisFft decimatedFft{};
+        static AnalysisFrontEnd decimator{};
+        static auto decimated = AnalysisBeatDetector(decimatedFft, decimator);
+        (void)decimated.Initialize();
+        Detectors::Run("decimation", "decimated", decimated);
+
+        static FullRateDetector::Fft fullRateFft{};
+        static FullRateFrontEnd lowPass{};
+        static auto fullRate = FullRateDetector(fullRateFft, lowPass);
+        (void)fullRate.Initialize();
+        Detectors::Run("decimation", "full_rate", fullRate);
+#endif
+    }
+}
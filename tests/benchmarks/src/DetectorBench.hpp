@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Bench.hpp"
+#include "SyntheticTrack.hpp"
+#include "SignalProcessing/SignalProcessingBase.hpp"
+
+namespace Benchmarks::Detectors
+{
+    /**
+     * Runs beat detection chains over the synthetic track. Every chain prints host ns/frame and the
+     * frames its kick band (bit 0) fired in; scripts/run_benchmarks.py scores them against the
+     * track's kicks and compares the decisions of the same chain across builds (float vs Q15).
+     */
+    using Frames = std::array<SignalProcessing::SampleFrame, SyntheticTrack::FrameCount>;
+
+    // generated once: the track is the same for every chain
+    inline const Frames& Track()
+    {
+        static Frames frames{};
+        static bool generated = false;
+        if (!generated)
+        {
+            auto track = SyntheticTrack();
+            for (auto& frame : frames)
+            {
+                track.Next(frame);
+            }
+
+            printk("{\"bench\":\"synthetic_track\",\"build\":\"%s\",\"frames\":%u,\"frame_ms\":%.3f,\"kicks_ms\":[",
+                   Build(), SyntheticTrack::FrameCount, static_cast<double>(SyntheticTrack::Frame_ms));
+            for (uint32_t k = 0; k < track.KickCount(); ++k)
+            {
+                printk(k == 0 ? "%u" : ",%u", track.Kick_ms(k));
+            }
+            printk("]}\n");
+            generated = true;
+        }
+        return frames;
+    }
+
+    // chain: anything with Process(const Frame&) -> BeatMask, already initialised
+    template <typename Chain>
+    void Run(const char* bench, const char* variant, Chain& chain)
+    {
+        const auto& frames = Track();
+        static std::array<uint16_t, SyntheticTrack::FrameCount> kicks{};
+        uint32_t kickCount = 0;
+
+        const auto start = HostNow_ns();
+        for (uint32_t n = 0; n < frames.size(); ++n)
+        {
+            if ((chain.Process(frames[n]) & BIT(0)) != 0)
+            {
+                kicks[kickCount++] = static_cast<uint16_t>(n);
+            }
+        }
+        const uint64_t ns = (HostNow_ns() - start) / frames.size();
+
+        printk("{\"bench\":\"%s\",\"build\":\"%s\",\"variant\":\"%s\",\"ns_per_frame\":%llu,\"kick_frames\":[",
+               bench, Build(), variant, ns);
+        for (uint32_t k = 0; k < kickCount; ++k)
+        {
+            printk(k == 0 ? "%u" : ",%u", kicks[k]);
+        }
+        printk("]}\n");
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Bench.hpp"
+#include "Core/MessagePublisher.hpp"
+#include "Core/MessageSubscriber.hpp"
+
+namespace Benchmarks::Dispatch
+{
+    /**
+     * MessageSubscriber dispatch of one zbus message per size from 16 B to 2 KiB, copied into the
+     * lane buffer against read in place (Topic::ClaimOnRead). Publish and DispatchOnce run on the
+     * same thread, so the host ns per message are the bus and the dispatch without a context
+     * switch; the publish is the same in both modes, the difference is the copy.
+     */
+    template <size_t Bytes>
+    struct Message
+    {
+        std::array<uint8_t, Bytes> payload;
+    };
+
+    static constexpr uint32_t Calls = 20000;
+}
+
+// per size a channel to the copying subscriber and one to the claiming one, foreign channel IDs
+ZBUS_SUBSCRIBER_DEFINE(bench_copy_sub, 4);
+ZBUS_SUBSCRIBER_DEFINE(bench_claim_sub, 4);
+#define BENCH_DISPATCH_CHANNELS(bytes)                                                                       \
+    ZBUS_CHAN_DEFINE(bench_copy_##bytes##_chan, Benchmarks::Dispatch::Message<bytes>, NULL, NULL,           \
+                     ZBUS_OBSERVERS(bench_copy_sub), ZBUS_MSG_INIT({}));                                     \
+    ZBUS_CHAN_DEFINE(bench_claim_##bytes##_chan, Benchmarks::Dispatch::Message<bytes>, NULL, NULL,          \
+                     ZBUS_OBSERVERS(bench_claim_sub), ZBUS_MSG_INIT({}))
+
+BENCH_DISPATCH_CHANNELS(16);
+BENCH_DISPATCH_CHANNELS(64);
+BENCH_DISPATCH_CHANNELS(256);
+BENCH_DISPATCH_CHANNELS(1024);
+BENCH_DISPATCH_CHANNELS(2048);
+
+namespace Benchmarks::Dispatch
+{
+    template <size_t Bytes>
+    using Topic = zbus_cpp::Topic<Message<Bytes>>;
+    using Publisher = zbus_cpp::MessagePublisher<Message<16>, Message<64>, Message<256>, Message<1024>, Message<2048>>;
+    using Subscriber = zbus_cpp::MessageSubscriber<Message<16>, Message<64>, Message<256>, Message<1024>,
+                                                   Message<2048>>;
+
+    K_THREAD_STACK_DEFINE(unused_lane_stack, 512); // lanes are dispatched by hand, never started
+    inline volatile uint8_t sink;
+
+    template <size_t Bytes>
+    void Measure(Publisher& publisher, Subscriber& subscriber, const bool claim)
+    {
+        (void)subscriber.Subscribe<Message<Bytes>>([](const Message<Bytes>& msg)
+        {
+            sink = msg.payload[0] ^ msg.payload[Bytes - 1];
+        });
+
+        Message<Bytes> msg{};
+        const uint64_t ns = NsPerCall(Calls, [&]
+        {
+            ++msg.payload[0];
+            (void)publisher.Publish(msg);
+            (void)subscriber.DispatchOnce(0, K_NO_WAIT);
+        });
+
+        const auto stats = subscriber.Stats<Message<Bytes>>();
+        printk("{\"bench\":\"dispatch\",\"build\":\"%s\",\"bytes\":%u,\"mode\":\"%s\",\"ns_per_message\":%llu,"
+               "\"delivered\":%u}\n", Build(), static_cast<unsigned>(Bytes), claim ? "claim" : "copy", ns,
+               stats.delivered);
+    }
+
+    template <size_t... Bytes>
+    void MeasureAll(Publisher& publisher, Subscriber& subscriber, const bool claim)
+    {
+        (Measure<Bytes>(publisher, subscriber, claim), ...);
+    }
+
+    inline void Run()
+    {
+        static auto worker = Utils::ThreadWorker(*unused_lane_stack, K_THREAD_STACK_SIZEOF(unused_lane_stack));
+
+        static auto copyPublisher = Publisher(
+            Topic<16>(&bench_copy_16_chan), Topic<64>(&bench_copy_64_chan), Topic<256>(&bench_copy_256_chan),
+            Topic<1024>(&bench_copy_1024_chan), Topic<2048>(&bench_copy_2048_chan));
+        static auto copySubscriber = Subscriber(
+            worker, &bench_copy_sub, Topic<16>(&bench_copy_16_chan), Topic<64>(&bench_copy_64_chan),
+            Topic<256>(&bench_copy_256_chan), Topic<1024>(&bench_copy_1024_chan), Topic<2048>(&bench_copy_2048_chan));
+        MeasureAll<16, 64, 256, 1024, 2048>(copyPublisher, copySubscriber, false);
+
+        static auto claimPublisher = Publisher(
+            Topic<16>(&bench_claim_16_chan), Topic<64>(&bench_claim_64_chan), Topic<256>(&bench_claim_256_chan),
+            Topic<1024>(&bench_claim_1024_chan), Topic<2048>(&bench_claim_2048_chan));
+        static auto claimSubscriber = Subscriber(
+            worker, &bench_claim_sub, Topic<16>(&bench_claim_16_chan).ClaimOnRead(),
+            Topic<64>(&bench_claim_64_chan).ClaimOnRead(), Topic<256>(&bench_claim_256_chan).ClaimOnRead(),
+            Topic<1024>(&bench_claim_1024_chan).ClaimOnRead(), Topic<2048>(&bench_claim_2048_chan).ClaimOnRead());
+        MeasureAll<16, 64, 256, 1024, 2048>(claimPublisher, claimSubscriber, true);
+    }
+}
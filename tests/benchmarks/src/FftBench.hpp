@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+
+#include "Bench.hpp"
+#include "SignalProcessing/BeatBands.hpp"
+#include "SignalProcessing/FftProcessor.hpp"
+
+namespace Benchmarks::Fft
+{
+    /**
+     * FftProcessor of the analysis chain in the modes the detectors can use, from the old path
+     * (no window, magnitude of every bin) to the current one (Hann, power of the beat bins only):
+     * host ns per call, the frame copy FftProcessor needs as scratch included. The leakage is the
+     * loudest bass band bin against the peak for a tone 6.4 bins above the kick band, with and
+     * without the window.
+     */
+    static constexpr uint32_t Calls = 20000;
+
+    template <SignalProcessing::FftWindow Window>
+    using AnalysisFft = SignalProcessing::FftProcessor<Constants::AnalysisSampleRate_hz, Constants::AnalysisWindowSize,
+                                                       Window>;
+    using Spectrum = SignalProcessing::AnalysisFft::Output;
+
+    // peak to the loudest bin of the kick band, in dB
+    inline float BassLeakage_dB(const Spectrum& power, const size_t lo, const size_t hi)
+    {
+        float peak = 0.0f;
+        float bass = 0.0f;
+        for (size_t i = 0; i < power.size(); ++i)
+        {
+            peak = power[i] > peak ? power[i] : peak;
+            bass = i >= lo && i < hi && power[i] > bass ? power[i] : bass;
+        }
+        return bass > 0.0f ? 10.0f * std::log10(bass / peak) : -200.0f;
+    }
+
+    template <typename Fft, typename Op>
+    void Measure(const char* variant, Fft& fft, const typename Fft::Input& frame, const bool leakage, Op&& op,
+                 const size_t lo, const size_t hi)
+    {
+        static typename Fft::Input scratch{};
+        static Spectrum output{};
+        const uint64_t ns = NsPerCall(Calls, [&]
+        {
+            scratch = frame;
+            op(fft, scratch, output);
+        });
+
+        printk("{\"bench\":\"fft\",\"build\":\"%s\",\"variant\":\"%s\",\"size\":%u,\"ns_per_call\":%llu", Build(),
+               variant, static_cast<unsigned>(Fft::Size), ns);
+        // power of every bin only
+        if (leakage)
+        {
+            printk(",\"bass_leakage_db\":%.1f", static_cast<double>(BassLeakage_dB(output, lo, hi)));
+        }
+        printk("}\n");
+    }
+
+    inline void Run()
+    {
+        using SignalProcessing::FftWindow;
+        using Hann = AnalysisFft<FftWindow::Hann>;
+        using Rectangular = AnalysisFft<FftWindow::Rectangular>;
+
+        constexpr auto kick = SignalProcessing::BeatBands.front();
+        constexpr size_t lo = Hann::Bin(kick.lo_hz);
+        constexpr size_t hi = Hann::BinEdge(kick.hi_hz);
+        constexpr size_t first = lo;
+        constexpr size_t end = Hann::BinEdge(SignalProcessing::BeatBands.back().hi_hz);
+        constexpr float tone_hz = (static_cast<float>(hi) + 6.4f) * Hann::BinWidth_hz;
+        static_assert(tone_hz < Constants::AnalysisSampleRate_hz / 2.0f, "test tone above Nyquist");
+
+        static Hann::Input frame{};
+        for (size_t n = 0; n < frame.size(); ++n)
+        {
+            const float x = 0.5f * std::sin(2.0f * 3.14159265f * tone_hz * n / Constants::AnalysisSampleRate_hz);
+#if defined(CONFIG_APP_DSP_Q15)
+            frame[n] = static_cast<int16_t>(x * 32767.0f);
+#else
+            frame[n] = x;
+#endif
+        }
+
+        static Rectangular rectangular{};
+        static Hann hann{};
+        (void)rectangular.Initialize();
+        (void)hann.Initialize();
+
+        Measure("rectangular_magnitude_all", rectangular, frame, false,
+                [](auto& fft, auto& in, auto& out) { fft.Magnitude(in, out); }, lo, hi);
+        Measure("rectangular_power_all", rectangular, frame, true,
+                [](auto& fft, auto& in, auto& out) { fft.Power(in, out); }, lo, hi);
+        Measure("hann_magnitude_all", hann, frame, false,
+                [](auto& fft, auto& in, auto& out) { fft.Magnitude(in, out); }, lo, hi);
+        Measure("hann_power_all", hann, frame, true,
+                [](auto& fft, auto& in, auto& out) { fft.Power(in, out); }, lo, hi);
+        Measure("hann_power_beat_bins", hann, frame, false,
+                [](auto& fft, auto& in, auto& out) { fft.Power(in, out, first, end); }, lo, hi);
+    }
+}
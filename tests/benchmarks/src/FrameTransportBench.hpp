@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Bench.hpp"
+#include "Core/EventTypes.hpp"
+#include "Core/FramePool.hpp"
+
+namespace Benchmarks::FrameTransport
+{
+    /**
+     * One audio frame from the producer to a subscriber over zbus, the samples carried by value
+     * (as before the frame pool) against the pooled buffer with only the handle on the bus.
+     * zbus copies the message into the channel on publish and the subscriber copies it out
+     * again (MessageSubscriber's lane buffer), so the bytes copied per frame are twice the
+     * message size; ns/frame is publish plus dispatch on the host.
+     */
+    struct CopiedFrame : Core::EventTypes::BaseEvent
+    {
+        int sample_rate_hz;
+        uint32_t sequence;
+        Core::AudioBuffer samples;
+    };
+
+    static constexpr uint32_t Frames = 20000;
+}
+
+// foreign channel IDs: the subscriber looks them up
+ZBUS_SUBSCRIBER_DEFINE(bench_frame_sub, 4);
+ZBUS_CHAN_DEFINE(BenchCopiedFrameChannel, Benchmarks::FrameTransport::CopiedFrame, NULL, NULL,
+                 ZBUS_OBSERVERS(bench_frame_sub), ZBUS_MSG_INIT({}));
+ZBUS_CHAN_DEFINE(BenchHandleFrameChannel, Core::EventTypes::AudioFrame, NULL, NULL,
+                 ZBUS_OBSERVERS(bench_frame_sub), ZBUS_MSG_INIT({}));
+
+namespace Benchmarks::FrameTransport
+{
+    using Core::EventTypes::AudioFrame;
+
+    K_THREAD_STACK_DEFINE(unused_lane_stack, 512); // lanes are dispatched by hand, never started
+
+    // bus buffers: the channel's message plus the lane buffer it is read into
+    inline void Print(const char* transport, const size_t message, const uint64_t ns)
+    {
+        printk("{\"bench\":\"frame_transport\",\"build\":\"%s\",\"transport\":\"%s\",\"message_bytes\":%u,"
+               "\"bytes_copied_per_frame\":%u,\"bus_buffer_bytes\":%u,\"ns_per_frame\":%llu}\n",
+               Build(), transport, static_cast<unsigned>(message), static_cast<unsigned>(2 * message),
+               static_cast<unsigned>(2 * message), ns);
+    }
+
+    inline void Run()
+    {
+        static auto worker = Utils::ThreadWorker(*unused_lane_stack, K_THREAD_STACK_SIZEOF(unused_lane_stack));
+        static auto publisher = zbus_cpp::MessagePublisher<CopiedFrame, AudioFrame>(
+            zbus_cpp::Topic<CopiedFrame>(&BenchCopiedFrameChannel), zbus_cpp::Topic<AudioFrame>(&BenchHandleFrameChannel));
+        static auto subscriber = zbus_cpp::MessageSubscriber<CopiedFrame, AudioFrame>(
+            worker, &bench_frame_sub, zbus_cpp::Topic<CopiedFrame>(&BenchCopiedFrameChannel),
+            zbus_cpp::Topic<AudioFrame>(&BenchHandleFrameChannel));
+        static auto pool = Core::AudioFramePool();
+        static volatile Constants::AudioSample sink;
+        static CopiedFrame copied{};
+
+        (void)subscriber.Subscribe<CopiedFrame>([](const CopiedFrame& frame)
+        {
+            sink = frame.samples[0][Constants::SamplingFrameSize - 1];
+        });
+        (void)subscriber.Subscribe<AudioFrame>([](const AudioFrame& frame)
+        {
+            // as AudioProcessingModule: a reference of its own while it reads the samples
+            if (const auto* samples = pool.Retain(frame.frame))
+            {
+                sink = (*samples)[0][Constants::SamplingFrameSize - 1];
+                pool.Release(frame.frame);
+            }
+        });
+
+        uint32_t sequence = 0;
+        const uint64_t copyNs = NsPerCall(Frames, [&]
+        {
+            copied.sequence = ++sequence;
+            copied.samples[0][Constants::SamplingFrameSize - 1] = static_cast<Constants::AudioSample>(sequence);
+            (void)publisher.Publish(copied);
+            (void)subscriber.DispatchOnce(0, K_NO_WAIT);
+        });
+        Print("by_value", sizeof(CopiedFrame), copyNs);
+
+        // as AudioSamplingModule: the channel holds a reference to the frame it carries
+        Core::FrameHandle published{};
+        const uint64_t handleNs = NsPerCall(Frames, [&]
+        {
+            AudioFrame frame{};
+            auto* buffer = pool.Acquire(frame.frame);
+            if (buffer == nullptr)
+            {
+                return;
+            }
+            frame.sequence = ++sequence;
+            (*buffer)[0][Constants::SamplingFrameSize - 1] = static_cast<Constants::AudioSample>(sequence);
+            (void)publisher.Publish(frame);
+            pool.Release(published);
+            published = frame.frame;
+            (void)subscriber.DispatchOnce(0, K_NO_WAIT);
+        });
+        pool.Release(published);
+        Print("handle", sizeof(AudioFrame), handleNs);
+
+        const auto stats = subscriber.Stats<AudioFrame>();
+        if (pool.Exhausted() != 0 || pool.Stale() != 0 || stats.dropped != 0)
+        {
+            printk("frame_transport: %u pool misses, %u stale, %u dropped\n", pool.Exhausted(), pool.Stale(),
+                   stats.dropped);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Bench.hpp"
+#include "Core/EventTypes.hpp"
+#include "Core/RingChannel.hpp"
+
+namespace Benchmarks::RingTransport
+{
+    /**
+     * Every message of AppMessages from a publishing thread to a subscriber lane, once over a zbus
+     * channel and once over a RingChannel, both through MessagePublisher / MessageSubscriber. The
+     * lanes run above the publisher as in the app, so every publish wakes its lane at once:
+     *  - round trip: publish, the handler gives a semaphore the publisher waits for;
+     *  - messages/s: publishes back to back, counted when the handler ran.
+     * Host ns, context switches included.
+     */
+    static constexpr uint32_t RoundTrips = 2000;
+    static constexpr uint32_t Messages = 20000;
+    static constexpr int PublisherPriority = 5;
+    static constexpr int LanePriority = 2;
+    static constexpr size_t RingDepth = 4;
+    static constexpr size_t TypeCount = 5; // AppMessages
+}
+
+// a channel and a lane observer per type, foreign channel IDs
+#define BENCH_RING_TRANSPORT_CHANNEL(name, type)                                                             \
+    ZBUS_SUBSCRIBER_DEFINE(name##_sub, 8);                                                                  \
+    ZBUS_CHAN_DEFINE(name##_chan, type, NULL, NULL, ZBUS_OBSERVERS(name##_sub), ZBUS_MSG_INIT({}))
+
+BENCH_RING_TRANSPORT_CHANNEL(bench_audio, Core::EventTypes::AudioFrame);
+BENCH_RING_TRANSPORT_CHANNEL(bench_beat, Core::EventTypes::BeatEvent);
+BENCH_RING_TRANSPORT_CHANNEL(bench_button, Core::EventTypes::ButtonEvent);
+BENCH_RING_TRANSPORT_CHANNEL(bench_tempo, Core::EventTypes::TempoEvent);
+BENCH_RING_TRANSPORT_CHANNEL(bench_spectrum, Core::EventTypes::SpectrumEvent);
+// the ring lanes wait on it besides their ring, nothing publishes to it
+ZBUS_SUBSCRIBER_DEFINE(bench_ring_idle_sub, 1);
+
+namespace Benchmarks::RingTransport
+{
+    // one lane per type and transport; they keep waiting once measured
+    K_THREAD_STACK_ARRAY_DEFINE(lane_stacks, 2 * TypeCount, 1024);
+    K_SEM_DEFINE(handled, 0, 1);
+    inline uint32_t delivered = 0;
+
+    template <typename MsgT, bool Ring>
+    void Measure(const char* type, const size_t lane, const zbus_cpp::Topic<MsgT> topic, const zbus_observer* observer)
+    {
+        static auto worker = Utils::ThreadWorker(*lane_stacks[lane], K_THREAD_STACK_SIZEOF(lane_stacks[lane]));
+        static auto publisher = zbus_cpp::MessagePublisher<MsgT>(topic);
+        static auto subscriber = zbus_cpp::MessageSubscriber<MsgT>(worker, observer, topic);
+
+        (void)subscriber.template Subscribe<MsgT>([](const MsgT&)
+        {
+            ++delivered;
+            k_sem_give(&handled);
+        });
+        subscriber.Initialize(LanePriority);
+        subscriber.Start();
+
+        MsgT msg{};
+        uint32_t lost = 0;
+        const auto start = HostNow_ns();
+        for (uint32_t i = 0; i < RoundTrips; ++i)
+        {
+            (void)publisher.Publish(msg);
+            lost += k_sem_take(&handled, K_MSEC(100)) != 0 ? 1 : 0;
+        }
+        const uint64_t roundTrip = (HostNow_ns() - start) / RoundTrips;
+
+        delivered = 0;
+        const auto burst = HostNow_ns();
+        for (uint32_t i = 0; i < Messages; ++i)
+        {
+            (void)publisher.Publish(msg);
+        }
+        const uint64_t burst_ns = HostNow_ns() - burst;
+        k_sem_reset(&handled);
+
+        const auto stats = subscriber.template Stats<MsgT>();
+        printk("{\"bench\":\"ring_transport\",\"build\":\"%s\",\"type\":\"%s\",\"transport\":\"%s\",\"bytes\":%u,"
+               "\"round_trip_ns\":%llu,\"messages_per_s\":%llu,\"delivered\":%u,\"dropped\":%u,\"lost\":%u}\n",
+               Build(), type, Ring ? "ring" : "zbus", static_cast<unsigned>(sizeof(MsgT)), roundTrip,
+               burst_ns ? delivered * 1'000'000'000ULL / burst_ns : 0, delivered, stats.dropped, lost);
+    }
+
+    template <typename MsgT>
+    void MeasureType(const char* type, const zbus_channel* chan, const zbus_observer* observer)
+    {
+        constexpr size_t index = Core::EventTypes::ChannelId<MsgT>;
+        static_assert(index < TypeCount, "more app messages than lanes");
+        static auto ring = zbus_cpp::RingChannel<MsgT, RingDepth>();
+        Measure<MsgT, false>(type, 2 * index, zbus_cpp::Topic<MsgT>(chan), observer);
+        Measure<MsgT, true>(type, 2 * index + 1, zbus_cpp::Topic<MsgT>(&ring), &bench_ring_idle_sub);
+    }
+
+    inline void Run()
+    {
+        using namespace Core::EventTypes;
+        const int priority = k_thread_priority_get(k_current_get());
+        k_thread_priority_set(k_current_get(), PublisherPriority);
+
+        MeasureType<AudioFrame>("AudioFrame", &bench_audio_chan, &bench_audio_sub);
+        MeasureType<BeatEvent>("BeatEvent", &bench_beat_chan, &bench_beat_sub);
+        MeasureType<ButtonEvent>("ButtonEvent", &bench_button_chan, &bench_button_sub);
+        MeasureType<TempoEvent>("TempoEvent", &bench_tempo_chan, &bench_tempo_sub);
+        MeasureType<SpectrumEvent>("SpectrumEvent", &bench_spectrum_chan, &bench_spectrum_sub);
+
+        k_thread_priority_set(k_current_get(), priority);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "DetectorBench.hpp"
+#include "SignalProcessing/BeatDetector.hpp"
+
+namespace Benchmarks::SampleFormat
+{
+    /**
+     * The band energy chain of the build (front end, FFT, detector) in the sample format of the
+     * build: run once with and once without CONFIG_APP_DSP_Q15 (scenario benchmarks.q15) and
+     * scripts/run_benchmarks.py reports ns/frame of both and how often their kick decisions agree.
+     */
+    inline void Run()
+    {
+        static SignalProcessing::AnalysisFft fft{};
+        static SignalProcessing::AnalysisFrontEnd frontEnd{};
+        static auto detector = SignalProcessing::AnalysisBeatDetector(fft, frontEnd);
+        (void)detector.Initialize();
+
+        Detectors::Run("sample_format", "band_energy", detector);
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "Constants.hpp"
+#include "SignalProcessing/SampleFormat.hpp"
+
+namespace Benchmarks
+{
+    /**
+     * Deterministic drum track at Constants::SampleRate_hz, mono, full scale 1.0: kicks at 120 BPM
+     * with a syncopated extra kick every second bar, snares on 2 and 4, closed hi-hats on the
+     * eighths, a sustained 55 Hz bass line through the middle third and a noise floor. The kick
+     * onsets are the ground truth of the detector benchmarks; everything else is there to trip
+     * the detectors up. The same track in every build, so results compare across builds.
+     */
+    class SyntheticTrack final
+    {
+    public:
+        static constexpr uint32_t Seconds = 16;
+        static constexpr uint32_t Samples = Seconds * Constants::SampleRate_hz;
+        static constexpr uint32_t FrameCount = Samples / Constants::SamplingFrameSize;
+        static constexpr float Frame_ms = 1000.0f * Constants::SamplingFrameSize / Constants::SampleRate_hz;
+
+        static constexpr uint32_t Beat_ms = 500;
+        static constexpr uint32_t MaxKicks = 2 * Seconds * 1000 / Beat_ms;
+
+        SyntheticTrack()
+        {
+            for (uint32_t beat = 1; beat * Beat_ms < Seconds * 1000 - Beat_ms; ++beat)
+            {
+                this->AddKick(beat * Beat_ms);
+                if (beat % 8 == 7)
+                {
+                    this->AddKick(beat * Beat_ms + Beat_ms / 2);
+                }
+            }
+        }
+
+        // the next of FrameCount frames
+        void Next(SignalProcessing::SampleFrame& frame)
+        {
+            for (auto& sample : frame)
+            {
+                sample = ToSample(this->Sample(this->position_++));
+            }
+        }
+
+        uint32_t KickCount() const { return this->kickCount_; }
+        uint32_t Kick_ms(const uint32_t k) const { return this->kicks_ms_[k]; }
+
+    private:
+        static constexpr float Pi = 3.14159265f;
+        static constexpr float Rate = Constants::SampleRate_hz;
+
+        void AddKick(const uint32_t at_ms)
+        {
+            if (this->kickCount_ < MaxKicks)
+            {
+                this->kicks_ms_[this->kickCount_++] = at_ms;
+            }
+        }
+
+        // t seconds after the onset
+        static float Kick(const float t)
+        {
+            // pitch drops from 110 to 50 Hz, phase is the integral of the frequency
+            const float phase = 2 * Pi * (50.0f * t + 60.0f * 0.03f * (1 - std::exp(-t / 0.03f)));
+            return 0.45f * std::exp(-t / 0.06f) * std::sin(phase);
+        }
+
+        float Sample(const uint32_t s)
+        {
+            const float t = static_cast<float>(s) / Rate;
+            const uint32_t t_ms = s * 1000 / Constants::SampleRate_hz;
+            const float noise = this->Noise();
+
+            float x = 0.005f * noise;
+            // kicks ring for 300 ms, the next one is at least 250 ms later
+            for (uint32_t k = 0; k < this->kickCount_ && this->kicks_ms_[k] <= t_ms; ++k)
+            {
+                if (t_ms < this->kicks_ms_[k] + 300)
+                {
+                    x += Kick(t - this->kicks_ms_[k] / 1000.0f);
+                }
+            }
+
+            const uint32_t inBeat_ms = t_ms % Beat_ms;
+            const float sinceBeat = static_cast<float>(inBeat_ms) / 1000.0f;
+            const uint32_t beat = t_ms / Beat_ms;
+            if (beat % 2 == 1 && inBeat_ms < 200)
+            {
+                // snare: noise and a 200 Hz body
+                x += std::exp(-sinceBeat / 0.04f) * (0.2f * noise + 0.1f * std::sin(2 * Pi * 200.0f * sinceBeat));
+            }
+            const float sinceEighth = static_cast<float>(t_ms % (Beat_ms / 2)) / 1000.0f;
+            // hi-hat: first difference of the noise, most energy near Nyquist
+            x += 0.05f * std::exp(-sinceEighth / 0.015f) * (noise - this->lastNoise_);
+            this->lastNoise_ = noise;
+
+            if (t >= Seconds / 3.0f && t < 2 * Seconds / 3.0f)
+            {
+                x += 0.12f * std::sin(2 * Pi * 55.0f * t);
+            }
+            // at most 0.45 + 0.3 + 0.1 + 0.12 + 0.005: no clipping in Q15
+            return x;
+        }
+
+        // uniform in [-1, 1), xorshift32
+        float Noise()
+        {
+            this->state_ ^= this->state_ << 13;
+            this->state_ ^= this->state_ >> 17;
+            this->state_ ^= this->state_ << 5;
+            return static_cast<float>(static_cast<int32_t>(this->state_)) / 2147483648.0f;
+        }
+
+        static Constants::AudioSample ToSample(const float x)
+        {
+#if defined(CONFIG_APP_DSP_Q15)
+            return static_cast<int16_t>(std::clamp(x * 32768.0f, -32768.0f, 32767.0f));
+#else
+            return x;
+#endif
+        }
+
+        std::array<uint32_t, MaxKicks> kicks_ms_{};
+        uint32_t kickCount_ = 0;
+        uint32_t position_ = 0;
+        uint32_t state_ = 0x2545F491;
+        float lastNoise_ = 0.0f;
+    };
+}
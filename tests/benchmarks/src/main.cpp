@@ -0,0 +1,45 @@
+#include <autoconf.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/adc.h>
+
+#include "Constants.hpp"
+#include "Core/EventTypes.hpp"
+
+#include "Bench.hpp"
+#include "AdcAcquisitionBench.hpp"
+#include "FrameTransportBench.hpp"
+#include "RingTransportBench.hpp"
+#include "DispatchBench.hpp"
+#include "SampleFormatBench.hpp"
+#include "DecimationBench.hpp"
+#include "BeatEngineBench.hpp"
+#include "FftBench.hpp"
+
+extern "C" {
+#include <nsi_main.h>
+}
+
+static constexpr adc_dt_spec adc_channels[] = {
+    DT_FOREACH_PROP_ELEM(DT_PATH(zephyr_user), io_channels,
+                         DT_SPEC_AND_COMMA)
+};
+
+int main()
+{
+    printk("benchmarks (%s)\n", Benchmarks::Build());
+
+    Benchmarks::FrameTransport::Run();
+    Benchmarks::RingTransport::Run();
+    Benchmarks::Dispatch::Run();
+    Benchmarks::SampleFormat::Run();
+    Benchmarks::Decimation::Run();
+    Benchmarks::BeatEngines::Run();
+    Benchmarks::Fft::Run();
+
+    // keeps the system workqueue and an acquisition thread busy: last
+    Benchmarks::AdcAcquisition::Run(adc_channels);
+
+    printk("benchmarks done\n");
+    nsi_exit(0);
+    return 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Just enough checking for the host tests: a failed check prints where and why, main() returns
+// HostTest::Result() so ctest sees the failure.
+namespace HostTest
+{
+    inline int& Failures()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline int Result()
+    {
+        if (Failures() != 0)
+        {
+            std::fprintf(stderr, "%d check(s) failed\n", Failures());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+}
+
+#define CHECK(cond)                                                                 \
+    do                                                                              \
+    {                                                                               \
+        if (!(cond))                                                                \
+        {                                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++HostTest::Failures();                                                 \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                     \
+    do                                                                              \
+    {                                                                               \
+        const double a_ = (actual);                                                 \
+        const double e_ = (expected);                                               \
+        if (!(std::fabs(a_ - e_) <= (tolerance)))                                   \
+        {                                                                           \
+            std::fprintf(stderr, "%s:%d: %s = %g, expected %g +- %g\n", __FILE__, __LINE__, #actual, a_, e_, \
+                         static_cast<double>(tolerance));                           \
+            ++HostTest::Failures();                                                 \
+        }                                                                           \
+    } while (0)
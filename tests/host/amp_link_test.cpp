@@ -0,0 +1,243 @@
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "HostTest.hpp"
+#include "Core/AmpLink.hpp"
+
+namespace
+{
+    struct Down
+    {
+        uint32_t sequence;
+        std::array<int16_t, 64> samples;
+    };
+
+    struct Up
+    {
+        uint32_t sequence;
+        int32_t sum;
+    };
+
+    using Region = Core::AmpRegion<Down, Up, 4, 8>;
+    using HostLink = Core::AmpLink<Region, Core::AmpSide::Host>;
+    using RemoteLink = Core::AmpLink<Region, Core::AmpSide::Remote>;
+
+    // The IPM doorbell on the host: a flag, so rings while the peer is busy coalesce into one wake-up.
+    class Doorbell
+    {
+    public:
+        void Ring()
+        {
+            {
+                std::lock_guard lock(this->mutex_);
+                this->rung_ = true;
+            }
+            this->cv_.notify_one();
+        }
+
+        // false on timeout
+        bool Wait(const std::chrono::milliseconds timeout)
+        {
+            std::unique_lock lock(this->mutex_);
+            const bool rung = this->cv_.wait_for(lock, timeout, [this] { return this->rung_; });
+            this->rung_ = false;
+            return rung;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool rung_ = false;
+    };
+
+    Down MakeDown(const uint32_t sequence)
+    {
+        Down d{sequence, {}};
+        for (size_t i = 0; i < d.samples.size(); ++i)
+        {
+            d.samples[i] = static_cast<int16_t>(sequence + i);
+        }
+        return d;
+    }
+
+    int32_t Sum(const Down& d)
+    {
+        int32_t sum = 0;
+        for (const auto s : d.samples)
+        {
+            sum += s;
+        }
+        return sum;
+    }
+
+    void RemoteWaitsForHost()
+    {
+        auto region = std::make_unique<Region>();
+        auto host = HostLink(*region, [] {});
+        auto remote = RemoteLink(*region, [] {});
+
+        // zeroed memory is not a region yet
+        CHECK(!remote.Attach());
+        Up up{};
+        CHECK(!remote.Send(up));
+        CHECK(remote.Dropped() == 1);
+
+        CHECK(host.Attach());
+        CHECK(remote.Attach());
+        CHECK(remote.Send(up));
+    }
+
+    // an image built with another frame size must not touch the rings
+    void RemoteRejectsOtherLayout()
+    {
+        auto region = std::make_unique<Region>();
+        auto host = HostLink(*region, [] {});
+        auto remote = RemoteLink(*region, [] {});
+        CHECK(host.Attach());
+
+        region->downSize = sizeof(Down) / 2;
+        CHECK(!remote.Attach());
+        region->downSize = sizeof(Down);
+        region->upSize = sizeof(Up) + 4;
+        CHECK(!remote.Attach());
+
+        // the host re-attaching writes its own layout again
+        CHECK(host.Attach());
+        CHECK(remote.Attach());
+    }
+
+    // The host resetting the region (the other core restarted) shows up on the remote's next check:
+    // it detaches while Magic is down and sees a new generation afterwards.
+    void RemoteFollowsHostReset()
+    {
+        auto region = std::make_unique<Region>();
+        auto host = HostLink(*region, [] {});
+        auto remote = RemoteLink(*region, [] {});
+        CHECK(host.Attach());
+        CHECK(remote.Attach());
+        const auto first = remote.Generation();
+        CHECK(first == host.Generation());
+        CHECK(host.Send(MakeDown(1)));
+
+        region->magic.store(0);
+        CHECK(!remote.Attach());
+        CHECK(!remote.Attached());
+        Down down{};
+        CHECK(!remote.Receive(down));
+
+        CHECK(host.Attach());
+        CHECK(remote.Attach());
+        CHECK(remote.Generation() != first);
+        // the reset emptied the rings
+        CHECK(!remote.Receive(down));
+        CHECK(host.Send(MakeDown(2)));
+        CHECK(remote.Receive(down));
+        CHECK(down.sequence == 2);
+    }
+
+    void FullRingIsCounted()
+    {
+        auto region = std::make_unique<Region>();
+        int rings = 0;
+        auto host = HostLink(*region, [&rings] { ++rings; });
+        CHECK(!host.Send(MakeDown(0)));
+        CHECK(host.Attach());
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            CHECK(host.Send(MakeDown(i)));
+        }
+        CHECK(!host.Send(MakeDown(4)));
+        CHECK(host.Dropped() == 2);
+        // the doorbell is only rung for delivered messages
+        CHECK(rings == 4);
+    }
+
+    // Host and remote on their own threads, each woken only by the other's doorbell: every frame
+    // comes back once, in order, with its payload intact. Run under -DHOST_TESTS_SANITIZER=thread.
+    void EchoBetweenThreads()
+    {
+        static constexpr uint32_t Count = 200'000;
+        auto region = std::make_unique<Region>();
+        Doorbell hostBell;
+        Doorbell remoteBell;
+        auto host = HostLink(*region, [&remoteBell] { remoteBell.Ring(); });
+        auto remote = RemoteLink(*region, [&hostBell] { hostBell.Ring(); });
+        CHECK(host.Attach());
+
+        auto remoteThread = std::thread([&remote, &remoteBell]
+        {
+            while (!remote.Attach())
+            {
+                std::this_thread::yield();
+            }
+            Down down{};
+            uint32_t last = 0;
+            while (last + 1 < Count)
+            {
+                // drain completely: the doorbells that woke us may have coalesced
+                while (remote.Receive(down))
+                {
+                    last = down.sequence;
+                    const Up up{down.sequence, Sum(down)};
+                    while (!remote.Send(up))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                if (last + 1 < Count)
+                {
+                    remoteBell.Wait(std::chrono::milliseconds(1000));
+                }
+            }
+        });
+
+        uint32_t sent = 0;
+        uint32_t expected = 0;
+        uint32_t outOfOrder = 0;
+        uint32_t wrongSum = 0;
+        Up up{};
+        while (expected < Count)
+        {
+            bool progress = false;
+            if (sent < Count && host.Send(MakeDown(sent)))
+            {
+                ++sent;
+                progress = true;
+            }
+            while (host.Receive(up))
+            {
+                outOfOrder += up.sequence == expected ? 0 : 1;
+                wrongSum += up.sum == Sum(MakeDown(up.sequence)) ? 0 : 1;
+                expected = up.sequence + 1;
+                progress = true;
+            }
+            // a full down ring frees up without a doorbell, so only wait briefly
+            if (!progress)
+            {
+                hostBell.Wait(std::chrono::milliseconds(1));
+            }
+        }
+        remoteThread.join();
+
+        CHECK(sent == Count);
+        CHECK(outOfOrder == 0);
+        CHECK(wrongSum == 0);
+        CHECK(!host.Receive(up));
+    }
+}
+
+int main()
+{
+    RemoteWaitsForHost();
+    RemoteRejectsOtherLayout();
+    RemoteFollowsHostReset();
+    FullRingIsCounted();
+    EchoBetweenThreads();
+    return HostTest::Result();
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "HostTest.hpp"
+#include "Utils/StreamingStats.hpp"
+
+namespace
+{
+    // exact q-quantile of the samples, for comparison
+    double Quantile(std::vector<float> samples, const double q)
+    {
+        const auto k = static_cast<size_t>(q * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(k), samples.end());
+        return samples[k];
+    }
+
+    void SeedsWithFirstSample()
+    {
+        auto estimator = Utils::QuantileEstimator(0.5f);
+        CHECK_NEAR(estimator.Add(7.0f), 7.0, 0.0);
+        CHECK_NEAR(estimator.Value(), 7.0, 0.0);
+    }
+
+    void SettlesOnTheMedian()
+    {
+        auto rng = std::mt19937(7);
+        auto uniform = std::uniform_real_distribution<float>(0.0f, 1.0f);
+        auto estimator = Utils::QuantileEstimator(0.5f, 0.1f);
+        for (int i = 0; i < 5000; ++i)
+        {
+            estimator.Add(uniform(rng));
+        }
+        CHECK_NEAR(estimator.Value(), 0.5, 0.08);
+    }
+
+    // the latency use: a long tail, where the 99th percentile is far from the mean
+    void SettlesOnATailPercentile()
+    {
+        auto rng = std::mt19937(11);
+        auto exponential = std::exponential_distribution<float>(1.0f / 2'000'000.0f); // mean 2 ms in ns
+        auto estimator = Utils::QuantileEstimator(0.99f);
+        std::vector<float> samples(50'000);
+        for (auto& x : samples)
+        {
+            x = exponential(rng);
+            estimator.Add(x);
+        }
+        const double exact = Quantile(samples, 0.99);
+        CHECK_NEAR(estimator.Value(), exact, 0.2 * exact);
+    }
+
+    // the step follows the spread, so the same samples at another scale give the same estimate scaled
+    void IsScaleFree()
+    {
+        auto rng = std::mt19937(3);
+        auto normal = std::normal_distribution<float>(0.0f, 1.0f);
+        auto unit = Utils::QuantileEstimator(0.5f, 0.1f);
+        auto scaled = Utils::QuantileEstimator(0.5f, 0.1f);
+        for (int i = 0; i < 2000; ++i)
+        {
+            const float x = normal(rng);
+            unit.Add(x);
+            scaled.Add(1000.0f * x);
+        }
+        CHECK_NEAR(scaled.Value(), 1000.0 * unit.Value(), 1e-2);
+    }
+
+    // the flux detector relies on the median following a change of level within a few hundred ms
+    void FollowsALevelChange()
+    {
+        auto rng = std::mt19937(5);
+        auto uniform = std::uniform_real_distribution<float>(0.0f, 1.0f);
+        auto estimator = Utils::QuantileEstimator(0.5f, 0.1f);
+        for (int i = 0; i < 500; ++i)
+        {
+            estimator.Add(uniform(rng));
+        }
+        for (int i = 0; i < 100; ++i)
+        {
+            estimator.Add(10.0f + uniform(rng));
+        }
+        CHECK_NEAR(estimator.Value(), 10.5, 0.3);
+    }
+}
+
+int main()
+{
+    SeedsWithFirstSample();
+    SettlesOnTheMedian();
+    SettlesOnATailPercentile();
+    IsScaleFree();
+    FollowsALevelChange();
+    return HostTest::Result();
+}
@@ -0,0 +1,104 @@
+#include <cmath>
+#include <cstdint>
+
+#include "HostTest.hpp"
+#include "SignalProcessing/Resampler.hpp"
+
+namespace
+{
+    constexpr double Pi = 3.14159265358979323846;
+
+    using Mono = SignalProcessing::Resampler<1>;
+
+    // Resamples a sine of the given frequency and returns the largest deviation from the ideal
+    // output sine (expectedGain 1) or the RMS of the output (expectedGain 0), after the kernel
+    // has filled.
+    double Tone(const int inputRate, const int outputRate, const double frequency, const double expectedGain)
+    {
+        auto resampler = Mono(inputRate, outputRate);
+        uint64_t in = 0;
+        double worst = 0.0;
+        double power = 0.0;
+        constexpr int Warmup = 200;
+        constexpr int Count = 5000;
+        for (int n = 0; n < Warmup + Count; ++n)
+        {
+            while (resampler.NeedsInput())
+            {
+                resampler.Push({static_cast<float>(std::sin(2.0 * Pi * frequency * in / inputRate))});
+                ++in;
+            }
+            const double y = resampler.Pull()[0];
+            if (n < Warmup)
+            {
+                continue;
+            }
+            const double ideal = expectedGain * std::sin(2.0 * Pi * frequency * n / outputRate);
+            worst = std::fmax(worst, std::fabs(y - ideal));
+            power += y * y;
+        }
+        return expectedGain > 0.0 ? worst : std::sqrt(power / Count);
+    }
+
+    void SameRateIsIdentity()
+    {
+        // no delay either: input n comes out as output n
+        auto same = Mono(10'000, 10'000);
+        int pushed = 0;
+        for (int n = 0; n < 1000; ++n)
+        {
+            while (same.NeedsInput())
+            {
+                same.Push({static_cast<float>(pushed * pushed % 17)});
+                ++pushed;
+            }
+            CHECK_NEAR(same.Pull()[0], static_cast<double>(n * n % 17), 1e-4);
+        }
+    }
+
+    // in the pass band the output is the same sine, in phase, at the output's sample times
+    void PassBandKeepsTheSignal()
+    {
+        CHECK(Tone(44'100, 10'000, 1000.0, 1.0) < 5e-4);
+        CHECK(Tone(48'000, 10'000, 150.0, 1.0) < 5e-4);
+        CHECK(Tone(22'050, 10'000, 3000.0, 1.0) < 5e-4);
+        // upsampling: band limited input, nothing to remove
+        CHECK(Tone(8'000, 10'000, 1000.0, 1.0) < 5e-4);
+    }
+
+    // above the output's Nyquist frequency: would alias to 3 kHz, 2.5 kHz and 1 kHz
+    void StopBandDoesNotAlias()
+    {
+        CHECK(Tone(44'100, 10'000, 7000.0, 0.0) < 3e-4);
+        CHECK(Tone(48'000, 10'000, 7500.0, 0.0) < 3e-4);
+        CHECK(Tone(22'050, 10'000, 9000.0, 0.0) < 3e-4);
+    }
+
+    // the position advances exactly: output n sits at input n * 4.41 after a minute as after a frame
+    void NoDrift()
+    {
+        constexpr uint64_t Outputs = 600'000;
+        auto resampler = Mono(44'100, 10'000);
+        uint64_t in = 0;
+        for (uint64_t n = 0; n < Outputs; ++n)
+        {
+            while (resampler.NeedsInput())
+            {
+                resampler.Push({0.0f});
+                ++in;
+            }
+            (void)resampler.Pull();
+        }
+        // the kernel reaches HalfTaps samples past the last output position
+        CHECK(in == (Outputs - 1) * 44'100 / 10'000 + 48 + 1);
+    }
+}
+
+int main()
+{
+    SameRateIsIdentity();
+    PassBandKeepsTheSignal();
+    StopBandDoesNotAlias();
+    NoDrift();
+    return HostTest::Result();
+}
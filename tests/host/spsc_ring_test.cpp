@@ -0,0 +1,118 @@
+#include <array>
+#include <cstdint>
+#include <thread>
+
+#include "HostTest.hpp"
+#include "Core/SpscRing.hpp"
+
+namespace
+{
+    // big enough that a torn copy shows up as a checksum mismatch
+    struct Message
+    {
+        uint32_t sequence;
+        std::array<uint32_t, 15> payload;
+    };
+
+    Message Make(const uint32_t sequence)
+    {
+        Message m{sequence, {}};
+        for (size_t i = 0; i < m.payload.size(); ++i)
+        {
+            m.payload[i] = sequence * 2654435761u + static_cast<uint32_t>(i);
+        }
+        return m;
+    }
+
+    bool Intact(const Message& m)
+    {
+        return m.payload == Make(m.sequence).payload;
+    }
+
+    void EmptyAndFull()
+    {
+        Core::SpscRing<Message, 4> ring{};
+        Message m{};
+        CHECK(!ring.TryPop(m));
+        CHECK(ring.Size() == 0);
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            CHECK(ring.TryPush(Make(i)));
+        }
+        CHECK(ring.Size() == 4);
+        CHECK(!ring.TryPush(Make(4)));
+
+        // first in, first out; a pop makes room for exactly one more
+        CHECK(ring.TryPop(m) && m.sequence == 0);
+        CHECK(ring.TryPush(Make(4)));
+        CHECK(!ring.TryPush(Make(5)));
+        for (uint32_t i = 1; i <= 4; ++i)
+        {
+            CHECK(ring.TryPop(m) && m.sequence == i && Intact(m));
+        }
+        CHECK(!ring.TryPop(m));
+    }
+
+    // free running indices: many laps over a small ring keep the order
+    void WrapsAround()
+    {
+        Core::SpscRing<Message, 2> ring{};
+        Message m{};
+        for (uint32_t i = 0; i < 10'000; ++i)
+        {
+            CHECK(ring.TryPush(Make(i)));
+            CHECK(ring.TryPop(m) && m.sequence == i);
+        }
+        CHECK(ring.Size() == 0);
+    }
+
+    // Producer and consumer on their own threads, as on the two cores: nothing lost, duplicated,
+    // reordered or torn. Run under -DHOST_TESTS_SANITIZER=thread to check the memory ordering.
+    void TwoThreads()
+    {
+        static constexpr uint32_t Count = 1'000'000;
+        static Core::SpscRing<Message, 8> ring{};
+
+        auto producer = std::thread([]
+        {
+            for (uint32_t i = 0; i < Count; ++i)
+            {
+                const auto m = Make(i);
+                while (!ring.TryPush(m))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint32_t expected = 0;
+        uint32_t outOfOrder = 0;
+        uint32_t torn = 0;
+        Message m{};
+        while (expected < Count)
+        {
+            if (!ring.TryPop(m))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            outOfOrder += m.sequence == expected ? 0 : 1;
+            torn += Intact(m) ? 0 : 1;
+            expected = m.sequence + 1;
+        }
+        producer.join();
+
+        CHECK(outOfOrder == 0);
+        CHECK(torn == 0);
+        CHECK(!ring.TryPop(m));
+    }
+}
+
+int main()
+{
+    EmptyAndFull();
+    WrapsAround();
+    TwoThreads();
+    return HostTest::Result();
+}
@@ -0,0 +1,145 @@
+#include <array>
+#include <cstdint>
+#include <random>
+
+#include "HostTest.hpp"
+#include "Utils/StreamingStats.hpp"
+
+namespace
+{
+    // mean and population variance of the last N values, in double over the whole window
+    template <size_t N>
+    void Reference(const std::array<float, N>& window, double& mean, double& variance)
+    {
+        double sum = 0.0;
+        for (const auto x : window)
+        {
+            sum += x;
+        }
+        mean = sum / N;
+        double m2 = 0.0;
+        for (const auto x : window)
+        {
+            m2 += (x - mean) * (x - mean);
+        }
+        variance = m2 / N;
+    }
+
+    void EmaSeedsWithFirstSample()
+    {
+        auto ema = Utils::Ema(0.5f);
+        CHECK_NEAR(ema.Add(4.0f), 4.0, 0.0);
+        CHECK_NEAR(ema.Add(0.0f), 2.0, 1e-6);
+        CHECK_NEAR(ema.Add(0.0f), 1.0, 1e-6);
+        CHECK_NEAR(ema.Value(), 1.0, 1e-6);
+    }
+
+    void EmaStartsFromInitialValue()
+    {
+        auto ema = Utils::Ema(0.25f, 1.0f);
+        CHECK_NEAR(ema.Value(), 1.0, 0.0);
+        CHECK_NEAR(ema.Add(5.0f), 2.0, 1e-6);
+
+        // (1 - alpha)^n of a step remains after n samples: 3 * 0.75^40 = 3e-5
+        for (int i = 0; i < 40; ++i)
+        {
+            ema.Add(5.0f);
+        }
+        CHECK_NEAR(ema.Value(), 5.0, 1e-4);
+    }
+
+    void WindowStartsZeroFilled()
+    {
+        auto stats = Utils::WindowedStats<4>();
+        CHECK_NEAR(stats.Mean(), 0.0, 0.0);
+        CHECK_NEAR(stats.Variance(), 0.0, 0.0);
+
+        // 8 and three zeros: mean 2, variance (36 + 3 * 4) / 4
+        stats.Add(8.0f);
+        CHECK_NEAR(stats.Mean(), 2.0, 1e-6);
+        CHECK_NEAR(stats.Variance(), 12.0, 1e-5);
+        CHECK_NEAR(stats.StdDev(), std::sqrt(12.0), 1e-5);
+    }
+
+    void WindowEvictsOldestSample()
+    {
+        constexpr size_t N = 5;
+        auto stats = Utils::WindowedStats<N>();
+        std::array<float, N> window{};
+        for (size_t i = 0; i < 3 * N + 2; ++i)
+        {
+            const auto x = static_cast<float>(i * i % 7);
+            stats.Add(x);
+            window[i % N] = x;
+
+            double mean = 0.0;
+            double variance = 0.0;
+            Reference(window, mean, variance);
+            CHECK_NEAR(stats.Mean(), mean, 1e-5);
+            CHECK_NEAR(stats.Variance(), variance, 1e-4);
+        }
+
+        // a constant run pushes everything else out: no spread left
+        for (size_t i = 0; i < N; ++i)
+        {
+            stats.Add(3.0f);
+        }
+        CHECK_NEAR(stats.Mean(), 3.0, 1e-6);
+        CHECK_NEAR(stats.Variance(), 0.0, 1e-6);
+    }
+
+    // Small spread on a large offset is where the incremental update loses precision; the
+    // recomputation every N samples has to keep it bounded however long the run.
+    void RenormalisationBoundsDrift()
+    {
+        constexpr size_t N = 40;
+        auto stats = Utils::WindowedStats<N>();
+        std::array<float, N> window{};
+        auto rng = std::mt19937(1234);
+        auto noise = std::normal_distribution<float>(0.0f, 0.01f);
+
+        double worstMean = 0.0;
+        double worstStdDev = 0.0;
+        for (size_t i = 0; i < 2'000'000; ++i)
+        {
+            const float x = 1000.0f + noise(rng);
+            stats.Add(x);
+            window[i % N] = x;
+            if (i < N || i % 997 != 0)
+            {
+                continue;
+            }
+            double mean = 0.0;
+            double variance = 0.0;
+            Reference(window, mean, variance);
+            worstMean = std::fmax(worstMean, std::fabs(stats.Mean() - mean));
+            worstStdDev = std::fmax(worstStdDev, std::fabs(stats.StdDev() - std::sqrt(variance)));
+        }
+        // float resolution at 1000 is 6e-5
+        CHECK(worstMean < 1e-3);
+        CHECK(worstStdDev < 5e-3);
+
+        // right after a wrap the statistics are recomputed from the window
+        for (size_t i = 0; i < N; ++i)
+        {
+            const float x = 1000.0f + noise(rng);
+            stats.Add(x);
+            window[i] = x;
+        }
+        double mean = 0.0;
+        double variance = 0.0;
+        Reference(window, mean, variance);
+        CHECK_NEAR(stats.Mean(), mean, 1e-3);
+        CHECK_NEAR(stats.StdDev(), std::sqrt(variance), 2e-3);
+    }
+}
+
+int main()
+{
+    EmaSeedsWithFirstSample();
+    EmaStartsFromInitialValue();
+    WindowStartsZeroFilled();
+    WindowEvictsOldestSample();
+    RenormalisationBoundsDrift();
+    return HostTest::Result();
+}
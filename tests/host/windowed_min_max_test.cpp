@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "HostTest.hpp"
+#include "Utils/StreamingStats.hpp"
+
+namespace
+{
+    // checks Min() and Max() after every sample against a scan of the last N values
+    template <size_t N>
+    void CheckAgainstScan(const std::vector<float>& samples)
+    {
+        auto window = Utils::WindowedMinMax<N>();
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            window.Add(samples[i]);
+            const auto first = samples.begin() + static_cast<std::ptrdiff_t>(i + 1 >= N ? i + 1 - N : 0);
+            const auto last = samples.begin() + static_cast<std::ptrdiff_t>(i + 1);
+            CHECK_NEAR(window.Min(), *std::min_element(first, last), 0.0);
+            CHECK_NEAR(window.Max(), *std::max_element(first, last), 0.0);
+        }
+    }
+
+    void FollowsRandomSamples()
+    {
+        auto rng = std::mt19937(42);
+        auto uniform = std::uniform_real_distribution<float>(-1.0f, 1.0f);
+        std::vector<float> samples(5000);
+        std::generate(samples.begin(), samples.end(), [&] { return uniform(rng); });
+        CheckAgainstScan<1>(samples);
+        CheckAgainstScan<7>(samples);
+        CheckAgainstScan<64>(samples);
+    }
+
+    // monotonic runs fill one queue completely and empty the other on every sample
+    void HandlesMonotonicRuns()
+    {
+        std::vector<float> samples;
+        for (int i = 0; i < 100; ++i)
+        {
+            samples.push_back(static_cast<float>(i));
+        }
+        for (int i = 100; i > -100; --i)
+        {
+            samples.push_back(static_cast<float>(i));
+        }
+        CheckAgainstScan<16>(samples);
+    }
+
+    void KeepsEqualValuesUntilTheyLeave()
+    {
+        std::vector<float> samples(50, 2.0f);
+        samples[10] = 5.0f;
+        samples[30] = -1.0f;
+        CheckAgainstScan<8>(samples);
+    }
+
+    void StartsWithTheSamplesSeen()
+    {
+        auto window = Utils::WindowedMinMax<10>();
+        window.Add(3.0f);
+        CHECK_NEAR(window.Min(), 3.0, 0.0);
+        CHECK_NEAR(window.Max(), 3.0, 0.0);
+        window.Add(-2.0f);
+        CHECK_NEAR(window.Min(), -2.0, 0.0);
+        CHECK_NEAR(window.Max(), 3.0, 0.0);
+    }
+}
+
+int main()
+{
+    StartsWithTheSamplesSeen();
+    FollowsRandomSamples();
+    HandlesMonotonicRuns();
+    KeepsEqualValuesUntilTheyLeave();
+    return HostTest::Result();
+}